@@ -0,0 +1,30 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int arena_init(Arena* a, size_t cap) {
+    a->used = 0;
+    a->cap = arena_round(cap);
+    a->base = a->cap ? aligned_alloc(ARENA_ALIGN, a->cap) : NULL;
+    if (!a->base) {
+        a->cap = 0;
+        return cap == 0;
+    }
+    memset(a->base, 0, a->cap);
+    return 1;
+}
+
+void* arena_alloc(Arena* a, size_t n) {
+    size_t k = arena_round(n);
+    if (k > a->cap - a->used) return NULL;
+    void* p = a->base + a->used;
+    a->used += k;
+    return p;
+}
+
+void arena_free(Arena* a) {
+    free(a->base);
+    a->base = NULL;
+    a->cap = a->used = 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 시작할 때 한 번 잡는 메모리 - 격자/패널 크기에 따라 크기가 정해지는 배열은 모두 여기서 나눠 받음
+// 모듈마다 필요한 바이트를 먼저 계산해서(arena_round 합) 딱 그만큼 잡고, 도중에 늘리거나 따로 해제하지 않음
+
+#define ARENA_ALIGN 64 // 캐시 줄 - 나눠 준 배열끼리 같은 줄을 나눠 쓰지 않음
+
+typedef struct {
+    uint8_t* base;
+    size_t cap, used;
+} Arena;
+
+static inline size_t arena_round(size_t n) { // n바이트를 받을 때 실제로 차지하는 크기
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+int arena_init(Arena* a, size_t cap); // cap 바이트를 0으로 채워 잡음. 실패하면 0
+void* arena_alloc(Arena* a, size_t n); // 정렬된 n바이트 - 모자라면 NULL
+void arena_free(Arena* a); // 통째로 해제
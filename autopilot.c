@@ -0,0 +1,167 @@
+#include "autopilot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define AP_SAMPLES 65536 // 결정 시간 표본 (넘치면 오래된 것부터 덮어씀)
+#define BB_WORDS ((GRID_MAX + 63) / 64)
+
+// 줄마다 OCC_WORDS개 uint64_t (sim.h 비트보드와 같은 배치) - 크기는 가장 큰 격자 기준, 쓰는 건 GRID_H줄만
+typedef struct { uint64_t r[GRID_MAX * BB_WORDS]; } Board; // 비트 x = 열 x
+
+static uint32_t lat_ns[AP_SAMPLES];
+static uint64_t lat_n = 0, lat_max = 0, lat_sum = 0;
+static uint32_t games = 0, clears = 0;
+static uint64_t score_sum = 0;
+static int best = 0;
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline void bb_set(Board* b, Point p) { occ_set(b->r, p); }
+static inline void bb_clr(Board* b, Point p) { occ_clr(b->r, p); }
+static inline int bb_get(const Board* b, Point p) { return occ_get(b->r, p); }
+
+static void bb_copy(Board* dst, const Board* src) { // 쓰는 줄만
+    memcpy(dst->r, src->r, (size_t)GRID_H * OCC_WORDS * sizeof(uint64_t));
+}
+
+static void bb_zero(Board* b) {
+    memset(b->r, 0, (size_t)GRID_H * OCC_WORDS * sizeof(uint64_t));
+}
+
+// start에서 open 칸으로 퍼져 나감. 닿는 칸 수를 돌려주고, food에 처음 닿은 걸음 수를 *dist에 (못 닿으면 -1)
+// 먹이를 찾았고 need칸 이상 닿았으면 더 퍼지지 않고 멈춤 (그때 칸 수는 need 이상인 어떤 값)
+static int flood(const Board* open, Point start, const Board* food, int need, int* dist) {
+    Board seen, front, next;
+    const int nw = OCC_WORDS;
+    bb_zero(&seen);
+    bb_zero(&front);
+    bb_set(&seen, start);
+    bb_set(&front, start);
+    int area = 0;
+    *dist = bb_get(food, start) ? 0 : -1;
+
+    for (int step = 1;; step++) {
+        uint64_t any = 0, hit = 0;
+        for (int y = 0; y < GRID_H; y++) { // 한 걸음 = 모든 줄을 위/아래/좌/우로 한 번에 확장
+            const uint64_t* fr = &front.r[y * nw];
+            for (int i = 0; i < nw; i++) {
+                uint64_t f = fr[i] << 1 | fr[i] >> 1; // 옆 칸 - 워드 경계를 넘는 비트는 이웃 워드에서
+                if (i > 0) f |= fr[i - 1] >> 63;
+                if (i < nw - 1) f |= fr[i + 1] << 63;
+                if (y > 0) f |= fr[i - nw];
+                if (y < GRID_H - 1) f |= fr[i + nw];
+                int k = y * nw + i;
+                f &= open->r[k] & ~seen.r[k]; // open은 격자 밖 비트가 0
+                next.r[k] = f;
+                seen.r[k] |= f; // 다른 줄 계산은 front만 보므로 바로 합쳐도 됨
+                area += __builtin_popcountll(f);
+                any |= f;
+                hit |= f & food->r[k];
+            }
+        }
+        if (!any) break;
+        if (hit && *dist < 0) *dist = step;
+        if (*dist >= 0 && area >= need) break;
+        bb_copy(&front, &next);
+    }
+    return area;
+}
+
+Dir autopilot_decide(const GameState* g) {
+    static const Dir opposite[] = { [DIR_UP] = DIR_DOWN, [DIR_DOWN] = DIR_UP, [DIR_LEFT] = DIR_RIGHT, [DIR_RIGHT] = DIR_LEFT };
+    const int nw = OCC_WORDS;
+    const uint64_t last = GRID_W % 64 ? (1ull << (GRID_W % 64)) - 1 : ~0ull; // 줄 마지막 워드에서 격자 안 비트
+    Board open, food, after;
+    bb_zero(&open);
+    bb_zero(&food);
+    for (int y = HUD_ROWS; y < GRID_H; y++) { // 플레이 영역 중 뱀이 없는 칸
+        for (int i = 0; i < nw; i++) {
+            int k = y * nw + i;
+            open.r[k] = ~g->occ[k] & (i == nw - 1 ? last : ~0ull);
+        }
+    }
+    for (int i = 0; i < FOOD_COUNT; i++) {
+        if (g->foods[i].x != FOOD_NONE.x) bb_set(&food, g->foods[i]);
+    }
+
+    Point h = game_snake_at(g, 0), tail = game_snake_at(g, g->snake_len - 1);
+    Dir cur = g->turn_n ? g->turns[g->turn_n - 1].dir : g->dir;
+    Dir pick = DIR_NONE;
+    int pick_room = 0, pick_dist = 0, pick_area = -1;
+
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        if (d == (int)opposite[cur]) continue;
+        Point n = h;
+        if (d == DIR_UP) n.y--;
+        else if (d == DIR_DOWN) n.y++;
+        else if (d == DIR_LEFT) n.x--;
+        else n.x++;
+        if (n.x >= GRID_W || n.y >= GRID_H || n.y < HUD_ROWS || !bb_get(&open, n)) continue; // 규칙과 같이 꼬리 칸도 막힘
+
+        int eat = bb_get(&food, n);
+        bb_copy(&after, &open); // 움직인 뒤의 판: 머리가 n을 차지하고, 안 먹으면 꼬리 칸이 비음
+        bb_clr(&after, n);
+        if (!eat) bb_set(&after, tail);
+
+        int dist;
+        int area = flood(&after, n, &food, g->snake_len, &dist);
+        int room = area >= g->snake_len; // 몸 길이만큼 움직일 공간이 있어야 갇히지 않음
+        if (dist < 0) dist = 1 << 20;
+
+        int better;
+        if (pick == DIR_NONE) better = 1;
+        else if (room != pick_room) better = room;
+        else if (room && dist != pick_dist) better = dist < pick_dist;
+        else better = area > pick_area;
+        if (better) {
+            pick = (Dir)d;
+            pick_room = room;
+            pick_dist = dist;
+            pick_area = area;
+        }
+    }
+    return pick;
+}
+
+Dir autopilot_choose(const GameState* g) {
+    uint64_t t0 = mono_ns();
+    Dir d = autopilot_decide(g);
+    uint64_t dt = mono_ns() - t0;
+    lat_ns[lat_n % AP_SAMPLES] = (uint32_t)(dt > UINT32_MAX ? UINT32_MAX : dt);
+    lat_n++;
+    lat_sum += dt;
+    if (dt > lat_max) lat_max = dt;
+    return d;
+}
+
+void autopilot_game_over(int score, int clear) {
+    games++;
+    clears += clear != 0;
+    score_sum += (uint64_t)score;
+    if (score > best) best = score;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+void autopilot_report(void) {
+    static uint32_t s[AP_SAMPLES];
+    uint32_t n = lat_n < AP_SAMPLES ? (uint32_t)lat_n : AP_SAMPLES;
+    printf("autopilot: games %u, clears %u, mean score %.1f, best %d\n", games, clears,
+           games ? (double)score_sum / games : 0.0, best);
+    if (!n) return;
+    memcpy(s, lat_ns, n * sizeof(uint32_t));
+    qsort(s, n, sizeof(uint32_t), cmp_u32);
+    printf("autopilot: decisions %llu, p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us, mean %.1f us\n",
+           (unsigned long long)lat_n, s[n / 2] / 1e3, s[n * 9 / 10] / 1e3, s[n * 99 / 100] / 1e3,
+           s[(uint64_t)n * 999 / 1000] / 1e3, lat_max / 1e3, (double)lat_sum / lat_n / 1e3);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "sim.h"
+
+// 자동 조종 - 사람 대신 방향을 고름 (장시간 부하 시험, 배치 시뮬레이션용)
+// GRID_W x GRID_H 판을 줄마다 uint64_t OCC_WORDS개인 비트보드(sim.h와 같은 배치)로 두고, 비트 연산으로 BFS(파도 확장)를 돌림
+// 후보 방향마다: 움직인 뒤 갈 수 있는 칸 수(flood fill)와 가장 가까운 먹이까지 거리를 구해서
+// 뱀 길이보다 넓은 쪽 중 먹이가 가까운 쪽, 그런 쪽이 없으면 가장 넓은 쪽을 고름
+
+Dir autopilot_decide(const GameState* g); // 다음 틱 방향 (DIR_NONE: 어디로 가도 죽음) - 전역 상태 없음, 스레드에서 써도 됨
+Dir autopilot_choose(const GameState* g); // autopilot_decide + 결정 시간 기록 (게임 루프용)
+
+// 결정 시간 통계 (autopilot_choose마다 실제 시계로 측정)
+void autopilot_game_over(int score, int clear); // 한 판 끝날 때 호출
+void autopilot_report(void); // 판 수/점수/결정 시간 백분위 출력
@@ -0,0 +1,360 @@
+// 여러 판을 모든 코어에서 동시에 시뮬레이션 - 난이도/먹이 설정(config.h) 조정용
+// 화면/GPIO 없이 sim.c만 씀. 작업 훔치기(work-stealing) 스레드 풀로 판 묶음을 나눠 돌림
+//
+// gcc -O2 -o snake_batch batch.c sim.c autopilot.c arena.c -pthread
+// ./snake_batch [판 수] [스레드 수] [시드] [greedy|auto|full] [격자 WxH,WxH,...]
+// 격자를 여러 개 주면 격자마다 같은 판 수를 돌려서 틱 하나 비용(스레드 시간 / 틱)과 GameState 메모리를 비교
+// full: 뱀이 플레이 영역을 거의 다 채운(SNAKE_CAP 근처) 판에서 시작해 해밀턴 순환을 따라 돌며 틱 비용만 잼
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "autopilot.h"
+#include "sim.h"
+
+#define BATCH_CHUNK 64 // 작업 하나 = 연속된 판 64개
+#define BATCH_MAX_STEPS 100000 // 한 판 최대 틱 (빙빙 도는 판 방지)
+
+typedef struct { uint32_t lo, hi; } Task; // 판 번호 [lo, hi)
+
+// 스레드마다 작업 덱: 주인은 뒤(bottom)에서 꺼내고, 일이 없는 스레드는 앞(top)에서 훔침
+typedef struct {
+    pthread_mutex_t mu;
+    Task* t;
+    int top, bottom;
+} Deque;
+
+typedef struct {
+    uint64_t games, steps, score_sum, len_sum, clears, capped, steals;
+    uint64_t cpu_ns; // 스레드 CPU 시간 - 코어보다 스레드가 많아도 틱 비용을 바로 잼
+    uint64_t tick_ns; // full: 틱 루프만의 스레드 CPU 시간 (판 만들기 O(칸 수)는 뺌)
+    int max_score;
+    uint64_t score_hist[GRID_MAX + 1]; // 점수별 판 수 - CLEAR_SCORE(기본 격자 너비)까지
+} Totals;
+
+typedef struct {
+    int id;
+    pthread_t th;
+    Totals tot;
+} Worker;
+
+static Deque* deques;
+static int nworkers;
+static uint64_t base_seed;
+typedef enum { PLAYER_GREEDY, PLAYER_AUTO, PLAYER_FULL } Player;
+static Player player = PLAYER_GREEDY; // auto: autopilot_decide (BFS/flood fill), greedy: bot_choose, full: 순환 따라가기
+static const char* const player_names[] = { "greedy", "auto", "full" };
+
+static Point* cycle = NULL; // full: 플레이 영역 전체를 한 번씩 지나 제자리로 오는 순환 (칸 순서)
+static uint8_t* cycle_dir = NULL; // full: 칸 -> 순환의 다음 칸으로 가는 방향 [SNAKE_CAP]
+static int cycle_n = 0;
+
+static int hist_top(void) { // 점수 히스토그램 마지막 칸
+    return CLEAR_SCORE < GRID_MAX ? CLEAR_SCORE : GRID_MAX;
+}
+
+static int deque_pop(Deque* d, Task* out) { // 자기 덱에서 꺼내기
+    int ok = 0;
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom > d->top) {
+        *out = d->t[--d->bottom];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->mu);
+    return ok;
+}
+
+static int deque_steal(Deque* d, Task* out) { // 남의 덱 앞에서 훔치기
+    int ok = 0;
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom > d->top) {
+        *out = d->t[d->top++];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->mu);
+    return ok;
+}
+
+static uint64_t mix(uint64_t x) { // splitmix64 - 판 번호로 판마다 다른 시드
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static int safe(const GameState* g, Point p) { // 다음 틱에 p로 가도 죽지 않는지 (규칙과 같이 꼬리 칸도 막힘)
+    if (p.x >= GRID_W || p.y >= GRID_H || p.y < HUD_ROWS) return 0;
+    return !game_occupied(g, p);
+}
+
+static Point step_to(Point p, Dir d) {
+    if (d == DIR_UP) p.y--;
+    else if (d == DIR_DOWN) p.y++;
+    else if (d == DIR_LEFT) p.x--;
+    else if (d == DIR_RIGHT) p.x++;
+    return p;
+}
+
+static Dir bot_choose(const GameState* g, Rng* r) { // 간단한 플레이어: 안전한 방향 중 가장 가까운 먹이 쪽, 같으면 무작위
+    static const Dir opposite[] = { [DIR_UP] = DIR_DOWN, [DIR_DOWN] = DIR_UP, [DIR_LEFT] = DIR_RIGHT, [DIR_RIGHT] = DIR_LEFT };
+    Point h = game_snake_at(g, 0);
+    Dir best = DIR_NONE;
+    int best_d = 1 << 30, ties = 0;
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        if (d == (int)opposite[g->dir]) continue;
+        Point n = step_to(h, (Dir)d);
+        if (!safe(g, n)) continue;
+        int dist = 1 << 20;
+        for (int i = 0; i < FOOD_COUNT; i++) {
+            if (g->foods[i].x == FOOD_NONE.x) continue;
+            int dd = abs(g->foods[i].x - n.x) + abs(g->foods[i].y - n.y);
+            if (dd < dist) dist = dd;
+        }
+        if (dist < best_d) {
+            best_d = dist;
+            best = (Dir)d;
+            ties = 1;
+        } else if (dist == best_d && rng_below(r, (uint32_t)++ties) == 0) {
+            best = (Dir)d;
+        }
+    }
+    return best; // DIR_NONE이면 어디로 가도 죽음 - 그대로 진행
+}
+
+static Dir dir_between(Point a, Point b) { // 이웃한 두 칸
+    return b.x > a.x ? DIR_RIGHT : b.x < a.x ? DIR_LEFT : b.y > a.y ? DIR_DOWN : DIR_UP;
+}
+
+static int cycle_build(void) { // 지금 격자의 해밀턴 순환 - 줄(또는 열) 수가 짝수여야 있음. 없으면 0
+    int rows = GRID_H - HUD_ROWS, y0 = HUD_ROWS, n = 0;
+    free(cycle);
+    free(cycle_dir);
+    cycle = malloc(sizeof(Point) * SNAKE_CAP);
+    cycle_dir = malloc(SNAKE_CAP);
+    if (!cycle || !cycle_dir) return 0;
+    if (rows % 2 == 0) { // 1열부터 줄마다 지그재그, 0열로 올라와서 닫힘
+        for (int r = 0; r < rows; r++)
+            for (int k = 1; k < GRID_W; k++) cycle[n++] = (Point){ (uint16_t)(r & 1 ? GRID_W - k : k), (uint16_t)(y0 + r) };
+        for (int r = rows - 1; r >= 0; r--) cycle[n++] = (Point){ 0, (uint16_t)(y0 + r) };
+    } else if (GRID_W % 2 == 0) { // 맨 윗줄을 돌아오는 길로 두고 열마다 지그재그
+        for (int x = 0; x < GRID_W; x++)
+            for (int k = 1; k < rows; k++) cycle[n++] = (Point){ (uint16_t)x, (uint16_t)(x & 1 ? y0 + rows - k : y0 + k) };
+        for (int x = GRID_W - 1; x >= 0; x--) cycle[n++] = (Point){ (uint16_t)x, (uint16_t)y0 };
+    } else {
+        return 0;
+    }
+    cycle_n = n;
+    for (int i = 0; i < n; i++) cycle_dir[cycle[i].y * GRID_W + cycle[i].x] = (uint8_t)dir_between(cycle[i], cycle[(i + 1) % n]);
+    return 1;
+}
+
+static void full_reset(GameState* g, int start) { // 순환의 start부터 뱀을 깔아 둠 - 앞쪽 틈은 클리어까지 먹고 자랄 만큼만
+    int len = cycle_n - (CLEAR_SCORE + FOOD_COUNT + 2);
+    g->score = 0;
+    g->steps = 0;
+    g->status = GAME_RUNNING;
+    g->turn_n = 0;
+    memset(g->occ, 0, (size_t)GRID_H * OCC_WORDS * sizeof(uint64_t));
+    free_set_reset(&g->free);
+    g->snake_head = 0;
+    g->snake_len = len;
+    for (int i = 0; i < len; i++) { // 0이 머리 - 순환 순서로 가장 앞선 칸
+        Point p = cycle[(start + len - 1 - i) % cycle_n];
+        g->snake[i] = p;
+        occ_set(g->occ, p);
+        free_set_remove(&g->free, p.y * GRID_W + p.x);
+    }
+    Point h = g->snake[0];
+    g->dir = (Dir)cycle_dir[h.y * GRID_W + h.x];
+    for (int i = 0; i < FOOD_COUNT; i++) g->foods[i] = FOOD_NONE; // 첫 틱에 틈 안에 채워짐
+}
+
+static uint64_t thread_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void play_one(uint32_t idx, GameState* g, Totals* t) {
+    uint64_t seed = mix(base_seed + idx);
+    Rng bot;
+    rng_seed(&bot, mix(seed));
+    game_state_init(g, seed);
+
+    GameStatus st = GAME_RUNNING;
+    if (player == PLAYER_FULL) {
+        full_reset(g, (int)rng_below(&bot, (uint32_t)cycle_n));
+        uint64_t t0 = thread_ns();
+        while (st == GAME_RUNNING && g->steps < BATCH_MAX_STEPS) {
+            Point h = game_snake_at(g, 0);
+            GameInput in = { (Dir)cycle_dir[h.y * GRID_W + h.x], 0 };
+            st = game_step(g, &in, NULL);
+        }
+        t->tick_ns += thread_ns() - t0;
+    } else {
+        game_reset(g, NULL);
+        while (st == GAME_RUNNING && g->steps < BATCH_MAX_STEPS) {
+            GameInput in = { player == PLAYER_AUTO ? autopilot_decide(g) : bot_choose(g, &bot), 0 };
+            st = game_step(g, &in, NULL);
+        }
+    }
+
+    t->games++;
+    t->steps += g->steps;
+    t->score_sum += (uint64_t)g->score;
+    t->len_sum += (uint64_t)g->snake_len;
+    t->clears += st == GAME_CLEAR;
+    t->capped += st == GAME_RUNNING;
+    if (g->score > t->max_score) t->max_score = g->score;
+    t->score_hist[g->score > hist_top() ? hist_top() : g->score]++;
+}
+
+static void* worker_main(void* arg) {
+    Worker* w = arg;
+    GameState state; // 스레드마다 하나 - 판마다 다시 씀 (격자 크기 배열도)
+    GameState* g = &state;
+    Arena mem;
+    if (!arena_init(&mem, game_state_bytes())) return NULL;
+    if (!game_state_alloc(g, &mem)) {
+        arena_free(&mem);
+        return NULL;
+    }
+    uint32_t victim = (uint32_t)w->id;
+    Task task;
+    for (;;) {
+        if (!deque_pop(&deques[w->id], &task)) {
+            int found = 0; // 자기 일이 없으면 다른 스레드 덱을 돌아가며 훔침
+            for (int k = 1; k < nworkers && !found; k++) {
+                victim = (victim + 1) % (uint32_t)nworkers;
+                if (victim != (uint32_t)w->id) found = deque_steal(&deques[victim], &task);
+            }
+            if (!found) break; // 작업이 새로 생기지 않으므로 모두 비었으면 끝
+            w->tot.steals++;
+        }
+        for (uint32_t i = task.lo; i < task.hi; i++) play_one(i, g, &w->tot);
+    }
+    w->tot.cpu_ns = thread_ns();
+    arena_free(&mem);
+    return NULL;
+}
+
+static double wall_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void run_grid(uint32_t games) { // 지금 격자(grid_setup)로 games판 돌리고 결과 출력
+    if (player == PLAYER_FULL && !cycle_build()) {
+        printf("grid %dx%d: no Hamiltonian cycle (play rows and columns both odd)\n", GRID_W, GRID_H);
+        return;
+    }
+    // 처음에는 작업을 스레드마다 돌아가며 나눠 줌 - 판 길이가 제각각이라 빨리 끝난 스레드가 훔쳐 감
+    uint32_t ntasks = (games + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    Worker* ws = calloc((size_t)nworkers, sizeof(Worker));
+    if (!ws) {
+        printf("grid %dx%d: out of memory\n", GRID_W, GRID_H);
+        return;
+    }
+    for (int i = 0; i < nworkers; i++) {
+        deques[i].top = deques[i].bottom = 0;
+        deques[i].t = malloc(sizeof(Task) * (ntasks / (uint32_t)nworkers + 1));
+        if (!deques[i].t) { // 이미 받은 덱까지 돌려주고 이 격자는 건너뜀
+            printf("grid %dx%d: out of memory for %d task deques\n", GRID_W, GRID_H, nworkers);
+            while (i-- > 0) free(deques[i].t);
+            free(ws);
+            return;
+        }
+    }
+    for (uint32_t k = 0; k < ntasks; k++) {
+        Deque* d = &deques[k % (uint32_t)nworkers];
+        uint32_t lo = k * BATCH_CHUNK;
+        d->t[d->bottom++] = (Task){ lo, lo + BATCH_CHUNK < games ? lo + BATCH_CHUNK : games };
+    }
+
+    double t0 = wall_sec();
+    for (int i = 0; i < nworkers; i++) {
+        ws[i].id = i;
+        pthread_create(&ws[i].th, NULL, worker_main, &ws[i]);
+    }
+    Totals t = { 0 };
+    for (int i = 0; i < nworkers; i++) {
+        pthread_join(ws[i].th, NULL);
+        Totals* w = &ws[i].tot;
+        t.games += w->games;
+        t.steps += w->steps;
+        t.score_sum += w->score_sum;
+        t.len_sum += w->len_sum;
+        t.clears += w->clears;
+        t.capped += w->capped;
+        t.steals += w->steals;
+        t.cpu_ns += w->cpu_ns;
+        t.tick_ns += w->tick_ns;
+        if (w->max_score > t.max_score) t.max_score = w->max_score;
+        for (int s = 0; s <= hist_top(); s++) t.score_hist[s] += w->score_hist[s];
+    }
+    double wall = wall_sec() - t0;
+
+    double n = t.games ? (double)t.games : 1.0;
+    printf("games %llu, threads %d, player %s, wall %.3f s, steals %llu\n", (unsigned long long)t.games, nworkers,
+           player_names[player], wall, (unsigned long long)t.steals);
+    printf("ticks %llu (%.0f ticks/s, %.0f games/s, %.1f ns cpu/tick incl. player)\n", (unsigned long long)t.steps,
+           wall > 0 ? t.steps / wall : 0.0, wall > 0 ? t.games / wall : 0.0, t.steps ? (double)t.cpu_ns / t.steps : 0.0);
+    printf("grid %dx%d, food %d, clear %d: mean score %.2f, max %d, mean length %.1f, mean ticks %.1f\n",
+           GRID_W, GRID_H, FOOD_COUNT, CLEAR_SCORE, t.score_sum / n, t.max_score, t.len_sum / n, t.steps / n);
+    printf("memory %zu bytes per game state (arena), clear %.2f%%, capped at %d ticks %llu\n", game_state_bytes(),
+           100.0 * t.clears / n, BATCH_MAX_STEPS, (unsigned long long)t.capped);
+    if (player == PLAYER_FULL)
+        printf("near cap: %.1f ns cpu/tick (tick loop only), start length %d of %d play cells\n",
+               t.steps ? (double)t.tick_ns / t.steps : 0.0, cycle_n - (CLEAR_SCORE + FOOD_COUNT + 2), cycle_n);
+    printf("score histogram:");
+    for (int s = 0; s <= hist_top(); s++) printf(" %llu", (unsigned long long)t.score_hist[s]);
+    printf("\n");
+
+    for (int i = 0; i < nworkers; i++) free(deques[i].t);
+    free(ws);
+}
+
+int main(int argc, char** argv) {
+    uint32_t games = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 100000;
+    nworkers = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    base_seed = argc > 3 ? strtoull(argv[3], NULL, 0) : 1;
+    if (argc > 4) { // 모르는 이름이면 greedy로 돌리지 않고 끝냄
+        int i = 0;
+        while (i < 3 && strcmp(argv[4], player_names[i]) != 0) i++;
+        if (i == 3) {
+            printf("unknown player %s\nusage: %s [games] [threads] [seed] [greedy|auto|full] [grids WxH,WxH,...]\n", argv[4],
+                   argv[0]);
+            return 1;
+        }
+        player = (Player)i;
+    }
+    const char* grids = argc > 5 ? argv[5] : "24x24";
+    if (nworkers < 1) nworkers = 1;
+
+    deques = calloc((size_t)nworkers, sizeof(Deque));
+    if (!deques) return 1;
+    for (int i = 0; i < nworkers; i++) pthread_mutex_init(&deques[i].mu, NULL);
+
+    for (const char* p = grids; *p;) { // "WxH,WxH,..." - 격자마다 한 번씩
+        int w, h, k = 0;
+        if (sscanf(p, "%dx%d%n", &w, &h, &k) != 2 || !grid_setup(w, h, CELL_MIN)) {
+            printf("bad grid %s (%d-%d cells a side)\n", p, GRID_MIN, GRID_MAX);
+            return 1;
+        }
+        run_grid(games);
+        p += k;
+        if (*p == ',') p++;
+        if (*p) printf("\n");
+    }
+
+    for (int i = 0; i < nworkers; i++) pthread_mutex_destroy(&deques[i].mu);
+    free(deques);
+    free(cycle);
+    free(cycle_dir);
+    return 0;
+}
@@ -0,0 +1,284 @@
+// 프레임 캡처(SNAKE_CAPTURE, framecap.h 형식) 풀기 - 게임 코드 없이 혼자 빌드
+//
+// gcc -O2 -o snake_capdec capdec.c
+// ./snake_capdec cap.snkc                   프레임마다 틱/시각/사각형 수/바뀐 픽셀 수와 요약
+// ./snake_capdec cap.snkc png 접두어 [N]    N 프레임마다 PNG 한 장 (접두어_00012.png, 기본 매 프레임)
+// ./snake_capdec cap.snkc y4m 파일 [fps]    기록된 시각에 맞춰 고정 fps(기본 30)로 다시 뽑은 YUV4MPEG2 영상
+//
+// "바뀐 픽셀"은 사각형 안에서 바로 앞 화면과 실제로 다른 픽셀 - 사각형 넓이보다 많이 작으면 필요 없이 다시 그린 것
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAMECAP_KEY 1 // framecap.h와 같음
+
+static FILE* in = NULL;
+static int W = 0, H = 0;
+static uint16_t* canvas = NULL; // 지금까지 풀어 놓은 화면 (RGB565)
+static uint16_t* rowbuf = NULL;
+
+typedef struct {
+    uint64_t t_us;
+    uint32_t tick;
+    int flags, rects;
+    uint64_t area, changed;
+} Frame;
+
+static int open_stream(const char* path) {
+    uint8_t hdr[9];
+    in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return 0;
+    }
+    if (fread(hdr, 1, sizeof(hdr), in) != sizeof(hdr) || memcmp(hdr, "SNKC", 4) != 0 || hdr[4] != 1) {
+        printf("%s: not a capture stream (SNKC version 1)\n", path);
+        return 0;
+    }
+    W = hdr[5] | hdr[6] << 8;
+    H = hdr[7] | hdr[8] << 8;
+    canvas = calloc((size_t)W * H, sizeof(uint16_t));
+    rowbuf = malloc((size_t)W * sizeof(uint16_t));
+    return canvas && rowbuf;
+}
+
+static int cut(void) {
+    printf("stream truncated (capture was not closed cleanly)\n");
+    return 0;
+}
+
+static int read_frame_header(Frame* f) { // 끝이면 0 (중간에 잘린 파일은 경고 후 0)
+    uint8_t hdr[14];
+    size_t got = fread(hdr, 1, sizeof(hdr), in);
+    if (got == 0) return 0;
+    if (got != sizeof(hdr)) return cut();
+    memcpy(&f->t_us, &hdr[0], 8);
+    memcpy(&f->tick, &hdr[8], 4);
+    f->flags = hdr[12];
+    f->rects = hdr[13];
+    f->area = f->changed = 0;
+    return 1;
+}
+
+static int apply_frame(Frame* f) { // 헤더 다음의 사각형들을 canvas에 덮어쓰며 바뀐 픽셀을 셈
+    for (int i = 0; i < f->rects; i++) {
+        uint16_t r[4];
+        if (fread(r, sizeof(r), 1, in) != 1) return cut();
+        if (r[0] + r[2] > W || r[1] + r[3] > H) {
+            printf("bad rect %u,%u %ux%u in a %dx%d stream\n", r[0], r[1], r[2], r[3], W, H);
+            return 0;
+        }
+        for (int y = r[1]; y < r[1] + r[3]; y++) {
+            uint16_t* dst = &canvas[y * W + r[0]];
+            if (fread(rowbuf, sizeof(uint16_t), r[2], in) != r[2]) return cut();
+            for (int x = 0; x < r[2]; x++) f->changed += dst[x] != rowbuf[x];
+            memcpy(dst, rowbuf, (size_t)r[2] * sizeof(uint16_t));
+        }
+        f->area += (uint64_t)r[2] * r[3];
+    }
+    return 1;
+}
+
+static void rgb(uint16_t c, uint8_t* p) { // RGB565 -> 8비트씩 - hal_host.c의 SNAKE_DUMP와 같은 변환 (그림끼리 바로 비교)
+    p[0] = (uint8_t)(((c >> 11) & 0x1F) << 3);
+    p[1] = (uint8_t)(((c >> 5) & 0x3F) << 2);
+    p[2] = (uint8_t)((c & 0x1F) << 3);
+}
+
+// PNG - 압축 없이 deflate 저장 블록만 씀 (zlib 불필요, 한 장 240x320이면 230 KB)
+static uint32_t crc_table[256];
+
+static uint32_t crc32_update(uint32_t c, const uint8_t* p, size_t n) {
+    if (!crc_table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t k = i;
+            for (int j = 0; j < 8; j++) k = (k & 1) ? 0xEDB88320u ^ (k >> 1) : k >> 1;
+            crc_table[i] = k;
+        }
+    }
+    for (size_t i = 0; i < n; i++) c = crc_table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c;
+}
+
+static void be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void chunk(FILE* f, const char* type, const uint8_t* data, uint32_t n) {
+    uint8_t b[4];
+    be32(b, n);
+    fwrite(b, 1, 4, f);
+    fwrite(type, 1, 4, f);
+    fwrite(data, 1, n, f);
+    be32(b, ~crc32_update(crc32_update(~0u, (const uint8_t*)type, 4), data, n));
+    fwrite(b, 1, 4, f);
+}
+
+static int write_png(const char* path) {
+    size_t raw_n = (size_t)H * (1 + 3 * (size_t)W); // 줄마다 필터 바이트(0) + RGB
+    size_t blocks = (raw_n + 65534) / 65535;
+    uint8_t* raw = malloc(raw_n);
+    uint8_t* z = malloc(2 + raw_n + blocks * 5 + 4);
+    FILE* f = fopen(path, "wb");
+    if (!raw || !z || !f) {
+        perror(path);
+        free(raw);
+        free(z);
+        if (f) fclose(f);
+        return 0;
+    }
+    uint8_t* p = raw;
+    for (int y = 0; y < H; y++) {
+        *p++ = 0;
+        for (int x = 0; x < W; x++, p += 3) rgb(canvas[y * W + x], p);
+    }
+    size_t zn = 0;
+    uint32_t a = 1, b = 0; // adler32
+    z[zn++] = 0x78;
+    z[zn++] = 0x01;
+    for (size_t off = 0; off < raw_n;) {
+        uint32_t len = raw_n - off > 65535 ? 65535 : (uint32_t)(raw_n - off);
+        z[zn++] = off + len == raw_n; // BFINAL, 저장 블록
+        z[zn++] = (uint8_t)len;
+        z[zn++] = (uint8_t)(len >> 8);
+        z[zn++] = (uint8_t)~len;
+        z[zn++] = (uint8_t)(~len >> 8);
+        memcpy(&z[zn], &raw[off], len);
+        for (uint32_t i = 0; i < len; i++) {
+            a = (a + raw[off + i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        zn += len;
+        off += len;
+    }
+    be32(&z[zn], b << 16 | a);
+    zn += 4;
+
+    static const uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    uint8_t ihdr[13] = { 0 };
+    be32(&ihdr[0], (uint32_t)W);
+    be32(&ihdr[4], (uint32_t)H);
+    ihdr[8] = 8; // 8비트
+    ihdr[9] = 2; // RGB
+    fwrite(sig, 1, sizeof(sig), f);
+    chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    chunk(f, "IDAT", z, (uint32_t)zn);
+    chunk(f, "IEND", NULL, 0);
+    fclose(f);
+    free(raw);
+    free(z);
+    return 1;
+}
+
+// y4m - 4:2:0, 전체 범위 BT.601 (C420jpeg). 폭은 짝수(framecap), 높이가 홀수면 마지막 줄은 색차를 혼자 씀
+static void write_y4m_frame(FILE* f, uint8_t* planes) {
+    int cw = W / 2, ch = (H + 1) / 2;
+    uint8_t* Y = planes;
+    uint8_t* U = Y + (size_t)W * H;
+    uint8_t* V = U + (size_t)cw * ch;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint8_t c[3];
+            rgb(canvas[y * W + x], c);
+            Y[y * W + x] = (uint8_t)((299 * c[0] + 587 * c[1] + 114 * c[2] + 500) / 1000);
+        }
+    }
+    for (int cy = 0; cy < ch; cy++) {
+        for (int cx = 0; cx < cw; cx++) {
+            int r = 0, g = 0, b = 0, n = 0;
+            for (int dy = 0; dy < 2 && cy * 2 + dy < H; dy++) {
+                for (int dx = 0; dx < 2; dx++, n++) {
+                    uint8_t c[3];
+                    rgb(canvas[(cy * 2 + dy) * W + cx * 2 + dx], c);
+                    r += c[0];
+                    g += c[1];
+                    b += c[2];
+                }
+            }
+            double rr = (double)r / n, gg = (double)g / n, bb = (double)b / n;
+            U[cy * cw + cx] = (uint8_t)(128.5 - 0.168736 * rr - 0.331264 * gg + 0.5 * bb);
+            V[cy * cw + cx] = (uint8_t)(128.5 + 0.5 * rr - 0.418688 * gg - 0.081312 * bb);
+        }
+    }
+    fputs("FRAME\n", f);
+    fwrite(planes, 1, (size_t)W * H + 2 * (size_t)cw * ch, f);
+}
+
+static void print_frame(uint32_t i, const Frame* f, uint64_t t0) {
+    printf("frame %u tick %u t %.3f ms rects %d area %llu changed %llu%s\n", i, f->tick,
+           (double)(f->t_us - t0) / 1000.0, f->rects, (unsigned long long)f->area,
+           (unsigned long long)f->changed, f->flags & FRAMECAP_KEY ? " key" : "");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: %s capture.snkc [png prefix [every] | y4m out.y4m [fps]]\n", argv[0]);
+        return 1;
+    }
+    if (!open_stream(argv[1])) return 1;
+    const char* mode = argc > 2 ? argv[2] : "stats";
+    int png = strcmp(mode, "png") == 0, y4m = strcmp(mode, "y4m") == 0;
+    if ((png || y4m) && argc < 4) {
+        printf("%s needs an output name\n", mode);
+        return 1;
+    }
+    int every = png && argc > 4 ? atoi(argv[4]) : 1;
+    int fps = y4m && argc > 4 ? atoi(argv[4]) : 30;
+    if (every < 1) every = 1;
+    if (fps < 1) fps = 30;
+
+    FILE* vid = NULL;
+    uint8_t* planes = NULL;
+    if (y4m) {
+        vid = fopen(argv[3], "wb");
+        planes = malloc((size_t)W * H + 2 * (size_t)(W / 2) * ((H + 1) / 2));
+        if (!vid || !planes) {
+            perror(argv[3]);
+            return 1;
+        }
+        fprintf(vid, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", W, H, fps);
+    }
+
+    Frame f;
+    uint32_t n = 0, keys = 0, idle = 0, pngs = 0, vframes = 0;
+    uint64_t t0 = 0, t_last = 0, area = 0, changed = 0, max_changed = 0;
+    while (read_frame_header(&f)) {
+        if (n == 0) t0 = f.t_us;
+        while (vid && t0 + (uint64_t)vframes * 1000000u / fps < f.t_us) { // 이 프레임 전 시각은 바로 앞 화면 - 멈춘 시간도 그대로 보임
+            write_y4m_frame(vid, planes);
+            vframes++;
+        }
+        if (!apply_frame(&f)) break;
+        if (!png && !y4m) print_frame(n, &f, t0);
+        if (png && n % every == 0) {
+            char path[4096];
+            snprintf(path, sizeof(path), "%s_%05u.png", argv[3], n);
+            if (!write_png(path)) return 1;
+            pngs++;
+        }
+        keys += (f.flags & FRAMECAP_KEY) != 0;
+        idle += f.changed == 0;
+        area += f.area;
+        changed += f.changed;
+        if (f.changed > max_changed) max_changed = f.changed;
+        t_last = f.t_us;
+        n++;
+    }
+    if (vid) {
+        write_y4m_frame(vid, planes); // 마지막 화면
+        vframes++;
+        fclose(vid);
+        printf("y4m: %u frames at %d fps -> %s\n", vframes, fps, argv[3]);
+    }
+    if (png) printf("png: %u images -> %s_*.png\n", pngs, argv[3]);
+    printf("capture %dx%d: %u frames (%u key) over %.3f s, changed px mean %.0f max %llu, "
+           "rect area mean %.0f (%.1f%% actually changed), %u frames changed nothing\n",
+           W, H, n, keys, (double)(t_last - t0) / 1e6, n ? (double)changed / n : 0.0,
+           (unsigned long long)max_changed, n ? (double)area / n : 0.0, area ? 100.0 * changed / area : 0.0, idle);
+    return 0;
+}
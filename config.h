@@ -11,19 +11,49 @@
 #define PIN_A      6
 #define PIN_B      5
 
-// Grid configuration
-#define CELL 10
-#define GRID_W (ST7789_TFTWIDTH  / CELL) // 240 / 10
-#define GRID_H (ST7789_TFTHEIGHT / CELL)
+// Grid configuration - 칸 크기와 격자 크기는 시작할 때 정함 (main.c: SNAKE_CELL, 패널 크기 / 칸 크기)
+#define CELL_DEFAULT 10 // 240x240 패널이면 24 * 24 격자
+#define CELL_MIN 2      // 짝수만 - 타일 한 줄이 바이트 단위로 복사되도록
+#define CELL_MAX 40
+#define GRID_MAX (ST7789_MAX_DIM / CELL_MIN) // 한 변의 최대 칸 수 (160) - 고정 크기 배열의 상한
+#define GRID_MIN 8 // 대전 모드 두 뱀 배치에 필요한 최소 너비/높이
 
+extern int grid_cell, grid_w, grid_h; // sim.c - grid_setup으로만 바꿈
+#define CELL grid_cell
+#define GRID_W grid_w
+#define GRID_H grid_h
+#define OCC_WORDS ((GRID_W + 63) / 64) // 비트보드 한 줄의 uint64_t 수
+
+int grid_setup(int w, int h, int cell); // 격자 w*h칸, 칸 cell픽셀. 범위를 벗어나면 0 (그대로 둠)
+
+#ifndef FOOD_COUNT // 먹이 개수/클리어 점수는 -D로 바꿔서 snake_batch로 난이도 비교 가능
 #define FOOD_COUNT 5
+#endif
 #define HUD_ROWS 1
+#ifndef CLEAR_SCORE
 #define CLEAR_SCORE GRID_W
+#endif
+
+// Timing (ms)
+#define TICK_MS 120        // 게임 틱 주기 (기본 난이도)
+#define TICK_MS_MIN 60     // 난이도가 올라도 이보다 빨라지지 않음
+#define TICK_SPEEDUP_MS 0  // 점수 1점마다 줄어드는 틱 주기 (0이면 속도 고정)
+#define INPUT_POLL_MS 10   // 플레이 중 입력 확인 간격
+#define IDLE_MS 50         // 메뉴/일시정지 등에서 루프 간격
+#define TURN_QUEUE 3       // 미리 받아 두는 방향 전환 수 (틱마다 하나씩 적용)
+
+// Panel transfer format: 16 = RGB565 (COLMOD 0x55), 12 = RGB444 두 픽셀을 3바이트로 (COLMOD 0x53, SPI 25% 감소)
+#ifndef PANEL_BPP
+#define PANEL_BPP 16
+#endif
 
-// RGB565 colors
+// RGB565 colors (팔레트 기본 색 - palette.c)
 #define C_BLACK  0x0000
 #define C_WHITE  0xFFFF
 #define C_RED    0xF800
 #define C_GREEN  0x07E0
 #define C_BLUE   0x001F
 #define C_YELLOW 0xFFE0
+#define C_DKGREEN 0x0320 // 뱀 테두리
+#define C_NAVY   0x0010 // HUD 칸 테두리
+#define C_DKRED  0x7800 // 대전 모드 상대 뱀 테두리
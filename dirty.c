@@ -0,0 +1,54 @@
+#include "dirty.h"
+
+static int touches(const Rect* a, const Rect* b) { // 겹치거나 변이 맞닿아 있는지
+    return a->x <= b->x + b->w && b->x <= a->x + a->w &&
+           a->y <= b->y + b->h && b->y <= a->y + a->h;
+}
+
+static Rect unite(const Rect* a, const Rect* b) { // 두 사각형을 감싸는 사각형
+    int x0 = a->x < b->x ? a->x : b->x;
+    int y0 = a->y < b->y ? a->y : b->y;
+    int x1 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+    int y1 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+    return (Rect){ (int16_t)x0, (int16_t)y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+}
+
+static int area(const Rect* a) { return a->w * a->h; }
+
+void dirty_clear(DirtyList* d) {
+    d->n = 0;
+}
+
+void dirty_add(DirtyList* d, int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    Rect nr = { (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h };
+
+    // 합쳐진 사각형이 또 다른 사각형과 닿을 수 있으므로 더 이상 합칠 게 없을 때까지 반복
+    int merged = 1;
+    while (merged) {
+        merged = 0;
+        for (int i = 0; i < d->n; i++) {
+            if (!touches(&d->r[i], &nr)) continue;
+            nr = unite(&d->r[i], &nr);
+            d->r[i] = d->r[--d->n]; // 기존 항목 제거(마지막 항목으로 덮기)
+            merged = 1;
+            break;
+        }
+    }
+
+    if (d->n < DIRTY_MAX) {
+        d->r[d->n++] = nr;
+        return;
+    }
+
+    // 꽉 찼으면 합쳤을 때 늘어나는 면적이 가장 작은 항목과 합침
+    int best = 0, best_cost = 0x7FFFFFFF;
+    for (int i = 0; i < d->n; i++) {
+        Rect u = unite(&d->r[i], &nr);
+        int cost = area(&u) - area(&d->r[i]);
+        if (cost < best_cost) { best_cost = cost; best = i; }
+    }
+    Rect u = unite(&d->r[best], &nr);
+    d->r[best] = d->r[--d->n];
+    dirty_add(d, u.x, u.y, u.w, u.h); // 합친 결과가 다른 항목과 닿을 수 있으니 다시 추가
+}
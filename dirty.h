@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+#define DIRTY_MAX 16 // 프레임당 유지하는 최대 사각형 수 (넘치면 가장 가까운 것과 합침)
+
+typedef struct { int16_t x, y, w, h; } Rect; // 픽셀 좌표 사각형
+
+typedef struct {
+    Rect r[DIRTY_MAX];
+    int n;
+} DirtyList; // 이번 프레임에 바뀐 영역들
+
+void dirty_clear(DirtyList* d); // 목록 비우기
+void dirty_add(DirtyList* d, int x, int y, int w, int h); // 영역 추가, 겹치거나 맞닿으면 합침
@@ -1,59 +1,64 @@
 #include "font5x7.h"
 
+#include <string.h>
+
+#include "pixops.h"
 #include "render.h"
 #include "st7789.h"
 
-static const Glyph5x7 FONT[] = {
-    {' ', {0x00,0x00,0x00,0x00,0x00,0x00,0x00}},
-    {'!', {0x04,0x04,0x04,0x04,0x04,0x00,0x04}},
+// 문자 코드로 바로 찾는 128칸 표 - 컴파일할 때 채워짐, 없는 문자는 ch가 0
+static const Glyph5x7 FONT[128] = {
+    [' '] = {' ', {0x00,0x00,0x00,0x00,0x00,0x00,0x00}},
+    ['!'] = {'!', {0x04,0x04,0x04,0x04,0x04,0x00,0x04}},
 
-    {'0', {0x1E,0x21,0x23,0x25,0x29,0x31,0x1E}},
-    {'1', {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}},
-    {'2', {0x1E,0x21,0x01,0x02,0x04,0x08,0x3F}},
-    {'3', {0x1E,0x21,0x01,0x0E,0x01,0x21,0x1E}},
-    {'4', {0x02,0x06,0x0A,0x12,0x3F,0x02,0x02}},
-    {'5', {0x3F,0x20,0x3E,0x01,0x01,0x21,0x1E}},
-    {'6', {0x0E,0x10,0x20,0x3E,0x21,0x21,0x1E}},
-    {'7', {0x3F,0x01,0x02,0x04,0x08,0x08,0x08}},
-    {'8', {0x1E,0x21,0x21,0x1E,0x21,0x21,0x1E}},
-    {'9', {0x1E,0x21,0x21,0x1F,0x01,0x02,0x1C}},
+    ['0'] = {'0', {0x1E,0x21,0x23,0x25,0x29,0x31,0x1E}},
+    ['1'] = {'1', {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}},
+    ['2'] = {'2', {0x1E,0x21,0x01,0x02,0x04,0x08,0x3F}},
+    ['3'] = {'3', {0x1E,0x21,0x01,0x0E,0x01,0x21,0x1E}},
+    ['4'] = {'4', {0x02,0x06,0x0A,0x12,0x3F,0x02,0x02}},
+    ['5'] = {'5', {0x3F,0x20,0x3E,0x01,0x01,0x21,0x1E}},
+    ['6'] = {'6', {0x0E,0x10,0x20,0x3E,0x21,0x21,0x1E}},
+    ['7'] = {'7', {0x3F,0x01,0x02,0x04,0x08,0x08,0x08}},
+    ['8'] = {'8', {0x1E,0x21,0x21,0x1E,0x21,0x21,0x1E}},
+    ['9'] = {'9', {0x1E,0x21,0x21,0x1F,0x01,0x02,0x1C}},
 
-    {'A', {0x1E,0x21,0x21,0x3F,0x21,0x21,0x21}},
-    {'B', {0x3E,0x21,0x21,0x3E,0x21,0x21,0x3E}},
-    {'C', {0x1E,0x21,0x20,0x20,0x20,0x21,0x1E}},
-    {'D', {0x3E,0x21,0x21,0x21,0x21,0x21,0x3E}},
-    {'E', {0x3F,0x20,0x20,0x3E,0x20,0x20,0x3F}},
-    {'F', {0x3F,0x20,0x20,0x3E,0x20,0x20,0x20}},
-    {'G', {0x1E,0x21,0x20,0x27,0x21,0x21,0x1E}},
-    {'H', {0x21,0x21,0x21,0x3F,0x21,0x21,0x21}},
-    {'I', {0x1F,0x04,0x04,0x04,0x04,0x04,0x1F}},
-    {'J', {0x0F,0x02,0x02,0x02,0x02,0x22,0x1C}},
-    {'K', {0x21,0x22,0x24,0x38,0x24,0x22,0x21}},
-    {'L', {0x20,0x20,0x20,0x20,0x20,0x20,0x3F}},
-    {'M', {0x21,0x33,0x2D,0x21,0x21,0x21,0x21}},
-    {'N', {0x21,0x31,0x29,0x25,0x23,0x21,0x21}},
-    {'O', {0x1E,0x21,0x21,0x21,0x21,0x21,0x1E}},
-    {'P', {0x3E,0x21,0x21,0x3E,0x20,0x20,0x20}},
-    {'Q', {0x1E,0x21,0x21,0x21,0x25,0x22,0x1D}},
-    {'R', {0x3E,0x21,0x21,0x3E,0x24,0x22,0x21}},
-    {'S', {0x1F,0x20,0x20,0x1E,0x01,0x01,0x3E}},
-    {'T', {0x3F,0x04,0x04,0x04,0x04,0x04,0x04}},
-    {'U', {0x21,0x21,0x21,0x21,0x21,0x21,0x1E}},
-    {'V', {0x21,0x21,0x21,0x21,0x21,0x12,0x0C}},
-    {'W', {0x21,0x21,0x21,0x21,0x2D,0x33,0x21}},
-    {'X', {0x21,0x21,0x12,0x0C,0x12,0x21,0x21}},
-    {'Y', {0x21,0x21,0x12,0x0C,0x04,0x04,0x04}},
-    {'Z', {0x3F,0x01,0x02,0x04,0x08,0x10,0x3F}},
+    ['A'] = {'A', {0x1E,0x21,0x21,0x3F,0x21,0x21,0x21}},
+    ['B'] = {'B', {0x3E,0x21,0x21,0x3E,0x21,0x21,0x3E}},
+    ['C'] = {'C', {0x1E,0x21,0x20,0x20,0x20,0x21,0x1E}},
+    ['D'] = {'D', {0x3E,0x21,0x21,0x21,0x21,0x21,0x3E}},
+    ['E'] = {'E', {0x3F,0x20,0x20,0x3E,0x20,0x20,0x3F}},
+    ['F'] = {'F', {0x3F,0x20,0x20,0x3E,0x20,0x20,0x20}},
+    ['G'] = {'G', {0x1E,0x21,0x20,0x27,0x21,0x21,0x1E}},
+    ['H'] = {'H', {0x21,0x21,0x21,0x3F,0x21,0x21,0x21}},
+    ['I'] = {'I', {0x1F,0x04,0x04,0x04,0x04,0x04,0x1F}},
+    ['J'] = {'J', {0x0F,0x02,0x02,0x02,0x02,0x22,0x1C}},
+    ['K'] = {'K', {0x21,0x22,0x24,0x38,0x24,0x22,0x21}},
+    ['L'] = {'L', {0x20,0x20,0x20,0x20,0x20,0x20,0x3F}},
+    ['M'] = {'M', {0x21,0x33,0x2D,0x21,0x21,0x21,0x21}},
+    ['N'] = {'N', {0x21,0x31,0x29,0x25,0x23,0x21,0x21}},
+    ['O'] = {'O', {0x1E,0x21,0x21,0x21,0x21,0x21,0x1E}},
+    ['P'] = {'P', {0x3E,0x21,0x21,0x3E,0x20,0x20,0x20}},
+    ['Q'] = {'Q', {0x1E,0x21,0x21,0x21,0x25,0x22,0x1D}},
+    ['R'] = {'R', {0x3E,0x21,0x21,0x3E,0x24,0x22,0x21}},
+    ['S'] = {'S', {0x1F,0x20,0x20,0x1E,0x01,0x01,0x3E}},
+    ['T'] = {'T', {0x3F,0x04,0x04,0x04,0x04,0x04,0x04}},
+    ['U'] = {'U', {0x21,0x21,0x21,0x21,0x21,0x21,0x1E}},
+    ['V'] = {'V', {0x21,0x21,0x21,0x21,0x21,0x12,0x0C}},
+    ['W'] = {'W', {0x21,0x21,0x21,0x21,0x2D,0x33,0x21}},
+    ['X'] = {'X', {0x21,0x21,0x12,0x0C,0x12,0x21,0x21}},
+    ['Y'] = {'Y', {0x21,0x21,0x12,0x0C,0x04,0x04,0x04}},
+    ['Z'] = {'Z', {0x3F,0x01,0x02,0x04,0x08,0x10,0x3F}},
 };
 
-static const Glyph5x7* get_glyph(char c) { // 글리프 검색
+static const Glyph5x7* get_glyph(char c) { // 글리프 검색 - 표를 바로 인덱싱
     if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A'); // 소문자를 대문자로 변환
-    for (unsigned i = 0; i < sizeof(FONT) / sizeof(FONT[0]); i++) { // 글리프 배열 검색
-        if (FONT[i].ch == c) return &FONT[i]; // 일치하는 글리프 반환
-    }
-    return &FONT[0]; // 없으면 공백 글리프 반환
+    unsigned char u = (unsigned char)c;
+    if (u >= 128 || FONT[u].ch == 0) return &FONT[' ']; // 없으면 공백 글리프 반환
+    return &FONT[u];
 }
 
+static uint16_t span[ST7789_MAX_DIM * 7 * FONT_MAX_SCALE]; // 한 줄을 래스터화할 RGB565 버퍼 (가장 넓은 회전 기준)
+
 int str_len(const char* s) { // 문자열 길이 반환
     int n = 0;
     while (s[n]) n++;
@@ -83,3 +88,35 @@ void draw_text_center_px(const char* s, int py, int sdot, uint16_t color) { // 
         draw_char_5x7_px(px + i * (char_w + gap), py, s[i], sdot, color);
     }
 }
+
+void draw_text_line_px(const char* s, int py, int sdot, uint16_t color, uint16_t bg) { // 한 줄을 버퍼에 그린 뒤 창 하나로 전송
+    if (sdot < 1) sdot = 1;
+    if (sdot > FONT_MAX_SCALE) sdot = FONT_MAX_SCALE;
+
+    int len = str_len(s);
+    int char_w = 5 * sdot;
+    int gap = 1 * sdot;
+    int text_w = len * char_w + (len - 1) * gap;
+    int px = (ST7789_TFTWIDTH - text_w) / 2;
+    int h = 7 * sdot;
+
+    for (int row = 0; row < 7; row++) { // 글리프 한 행씩 그린 뒤 sdot줄로 복사
+        uint16_t* line = &span[row * sdot * ST7789_TFTWIDTH];
+        px_fill(line, bg, ST7789_TFTWIDTH); // 배경 포함
+        for (int i = 0; i < len; i++) {
+            uint8_t bits = get_glyph(s[i])->rows[row];
+            int cx = px + i * (char_w + gap);
+            for (int col = 0; col < 5; col++) {
+                if (!(bits & (1 << (4 - col)))) continue;
+                int x0 = cx + col * sdot, x1 = x0 + sdot;
+                if (x0 < 0) x0 = 0;
+                if (x1 > ST7789_TFTWIDTH) x1 = ST7789_TFTWIDTH;
+                if (x1 > x0) px_fill(&line[x0], color, (uint32_t)(x1 - x0));
+            }
+        }
+        for (int k = 1; k < sdot; k++) {
+            memcpy(line + k * ST7789_TFTWIDTH, line, ST7789_TFTWIDTH * sizeof(uint16_t));
+        }
+    }
+    blit_both(0, py, ST7789_TFTWIDTH, h, span);
+}
@@ -0,0 +1,199 @@
+#include "framecap.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "arena.h"
+#include "hal.h"
+#include "palette.h"
+#include "st7789.h"
+
+typedef struct {
+    uint64_t t_us;
+    uint32_t tick;
+    uint8_t flags, n;
+    Rect r[DIRTY_MAX]; // x, w는 짝수 - 4비트 바이트 단위로 복사
+    uint8_t* px;       // 사각형마다 줄 순서로 이어 붙인 4비트 픽셀
+} Slot;
+
+static FILE* out = NULL;
+static Arena mem;
+static Slot slots[FRAMECAP_SLOTS];
+static size_t slot_bytes = 0; // 칸 하나의 px 크기 = 4비트 화면 전체
+static uint16_t* row = NULL;  // 기록 스레드가 한 줄을 RGB565로 펼치는 버퍼
+
+static pthread_t writer;
+static pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static unsigned head = 0, tail = 0; // 게임 스레드가 head, 기록 스레드가 tail을 올림 (mu로 보호)
+static int stopping = 0;
+
+static uint32_t cur_tick = 0;
+static int need_key = 1; // 다음 프레임은 화면 전체로 (처음, 버린 프레임 뒤)
+static uint32_t n_frames = 0, n_dropped = 0, n_keys = 0;
+static uint64_t n_bytes = 0, n_pixels = 0;
+static uint64_t copy_sum_us = 0, copy_max_us = 0; // 게임 스레드가 framecap_frame에서 쓴 시간
+static uint64_t write_sum_us = 0;                 // 기록 스레드가 펼치고 쓴 시간
+
+static uint64_t mono_us(void) { // 오버헤드 측정용 실제 시계 (가상 시계에서도)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void put(const void* p, size_t n) {
+    fwrite(p, 1, n, out);
+    n_bytes += n;
+}
+
+static void write_slot(const Slot* s) { // 기록 스레드: 4비트 -> RGB565로 펼쳐서 씀
+    uint8_t hdr[14];
+    memcpy(&hdr[0], &s->t_us, 8);
+    memcpy(&hdr[8], &s->tick, 4);
+    hdr[12] = s->flags;
+    hdr[13] = s->n;
+    put(hdr, sizeof(hdr));
+    const uint8_t* src = s->px;
+    for (int i = 0; i < s->n; i++) {
+        const Rect* r = &s->r[i];
+        uint16_t rh[4] = { (uint16_t)r->x, (uint16_t)r->y, (uint16_t)r->w, (uint16_t)r->h };
+        put(rh, sizeof(rh));
+        for (int y = 0; y < r->h; y++) {
+            pal_expand_565(row, src, r->w / 2);
+            put(row, (size_t)r->w * 2);
+            src += r->w / 2;
+        }
+        n_pixels += (uint64_t)r->w * r->h;
+    }
+}
+
+static void* writer_main(void* arg) { // 기록 스레드: 큐 칸을 차례로 파일에 씀
+    (void)arg;
+    pthread_mutex_lock(&mu);
+    while (1) {
+        while (!stopping && tail == head) pthread_cond_wait(&cv, &mu);
+        if (tail == head) break; // 종료 요청 + 다 씀
+        const Slot* s = &slots[tail % FRAMECAP_SLOTS];
+        pthread_mutex_unlock(&mu);
+
+        uint64_t t0 = mono_us();
+        write_slot(s);
+        write_sum_us += mono_us() - t0;
+
+        pthread_mutex_lock(&mu);
+        tail++;
+        pthread_cond_broadcast(&cv); // 가상 시계에서는 게임 스레드가 빈 칸을 기다림
+    }
+    pthread_mutex_unlock(&mu);
+    fflush(out);
+    return NULL;
+}
+
+void framecap_init(void) {
+    const char* path = getenv("SNAKE_CAPTURE");
+    if (!path) return;
+    slot_bytes = (size_t)ST7789_TFTWIDTH / 2 * ST7789_TFTHEIGHT; // 폭은 짝수 (setup_geometry)
+    size_t row_bytes = (size_t)ST7789_TFTWIDTH * sizeof(uint16_t);
+    if (!arena_init(&mem, FRAMECAP_SLOTS * arena_round(slot_bytes) + arena_round(row_bytes))) {
+        printf("capture: out of memory\n");
+        return;
+    }
+    for (int i = 0; i < FRAMECAP_SLOTS; i++) slots[i].px = arena_alloc(&mem, slot_bytes);
+    row = arena_alloc(&mem, row_bytes);
+
+    out = fopen(path, "wb");
+    if (!out) {
+        perror(path);
+        arena_free(&mem);
+        return;
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 16);
+    uint8_t hdr[9] = { 'S', 'N', 'K', 'C', FRAMECAP_VERSION };
+    uint16_t w = ST7789_TFTWIDTH, h = ST7789_TFTHEIGHT;
+    memcpy(&hdr[5], &w, 2);
+    memcpy(&hdr[7], &h, 2);
+    put(hdr, sizeof(hdr));
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) { // 스레드 없이는 캡처 안 함 - 게임을 막지 않는 게 우선
+        fclose(out);
+        out = NULL;
+        arena_free(&mem);
+    }
+}
+
+void framecap_set_tick(uint32_t tick) {
+    cur_tick = tick;
+}
+
+static int fill(Slot* s, const uint8_t* fb, int stride, const DirtyList* d) { // 바뀐 영역 복사. 칸에 안 들어가면 0
+    size_t used = 0;
+    for (int i = 0; i < d->n; i++) {
+        int x0 = d->r[i].x & ~1, x1 = (d->r[i].x + d->r[i].w + 1) & ~1; // 두 픽셀이 한 바이트
+        Rect r = { (int16_t)x0, d->r[i].y, (int16_t)(x1 - x0), d->r[i].h };
+        size_t rb = (size_t)r.w / 2;
+        if (used + rb * r.h > slot_bytes) return 0; // 짝수로 넓히다 겹친 사각형이 많음 - 키 프레임으로
+        for (int y = r.y; y < r.y + r.h; y++) {
+            memcpy(&s->px[used], &fb[y * stride + x0 / 2], rb);
+            used += rb;
+        }
+        s->r[s->n++] = r;
+    }
+    return 1;
+}
+
+void framecap_frame(const uint8_t* fb, int stride, const DirtyList* d) {
+    if (!out) return;
+    uint64_t t0 = mono_us();
+    pthread_mutex_lock(&mu);
+    while (!hal_realtime() && head - tail >= FRAMECAP_SLOTS) pthread_cond_wait(&cv, &mu); // 가상 시계는 기다려도 시간이 안 감 - 빠짐없이
+    int full = head - tail >= FRAMECAP_SLOTS;
+    pthread_mutex_unlock(&mu);
+    if (full) { // 기록이 밀림 - 버리고 다음 프레임을 키 프레임으로
+        n_dropped++;
+        need_key = 1;
+        return;
+    }
+
+    Slot* s = &slots[head % FRAMECAP_SLOTS]; // 기록 스레드는 head 전 칸만 읽으므로 락 없이 채움
+    s->t_us = hal_now_us();
+    s->tick = cur_tick;
+    s->n = 0;
+    s->flags = 0;
+    if (need_key || !fill(s, fb, stride, d)) {
+        DirtyList all = { .r = { { 0, 0, ST7789_TFTWIDTH, ST7789_TFTHEIGHT } }, .n = 1 };
+        s->n = 0;
+        s->flags = FRAMECAP_KEY;
+        fill(s, fb, stride, &all);
+        need_key = 0;
+        n_keys++;
+    }
+    n_frames++;
+
+    pthread_mutex_lock(&mu);
+    head++;
+    pthread_cond_broadcast(&cv);
+    pthread_mutex_unlock(&mu);
+
+    uint64_t us = mono_us() - t0;
+    copy_sum_us += us;
+    if (us > copy_max_us) copy_max_us = us;
+}
+
+void framecap_report(void) {
+    if (!out) return;
+    pthread_mutex_lock(&mu);
+    stopping = 1;
+    pthread_cond_broadcast(&cv);
+    pthread_mutex_unlock(&mu);
+    pthread_join(writer, NULL);
+    fclose(out);
+    out = NULL;
+    arena_free(&mem);
+    printf("capture: %u frames (%u key), dropped %u, %.1f KB, %.0f px/frame\n", n_frames, n_keys, n_dropped,
+           n_bytes / 1024.0, n_frames ? (double)n_pixels / n_frames : 0.0);
+    printf("capture: game thread %.1f us/frame (max %llu us), writer %.1f us/frame\n",
+           n_frames ? (double)copy_sum_us / n_frames : 0.0, (unsigned long long)copy_max_us,
+           n_frames ? (double)write_sum_us / n_frames : 0.0);
+}
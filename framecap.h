@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "dirty.h"
+
+// 프레임 캡처 - 패널로 넘긴 프레임마다 바뀐 영역만 RGB565로 파일에 씀 (SNAKE_CAPTURE=파일)
+// 미러 창이 없는 기기에서도 렉 걸린 판에 패널이 실제로 뭘 보여 줬는지 나중에 볼 수 있음 (capdec.c로 풀기)
+// 게임 스레드는 4비트 프레임버퍼의 바뀐 줄을 큐 칸에 복사만 하고, 펼치기/파일 쓰기는 기록 스레드가 함
+// 큐가 꽉 차면 그 프레임은 버리고 다음 프레임을 화면 전체(키 프레임)로 써서 이어 붙일 수 있게 함 - 게임은 기다리지 않음
+// (가상 시계(호스트 백엔드)에서는 기다려도 게임 시간이 안 가므로 빈 칸이 날 때까지 기다려서 모든 프레임을 씀)
+//
+// 파일 형식 (리틀 엔디언):
+//   "SNKC" 버전(1바이트) 너비(2) 높이(2)
+//   프레임: 시각 us(8, hal_now_us) 틱(4) 플래그(1, FRAMECAP_KEY) 사각형 수(1)
+//           사각형마다 x y w h (각 2바이트) + w*h 픽셀 RGB565(2바이트씩, 줄 순서)
+//   파일 끝이 곧 스트림 끝
+
+#define FRAMECAP_VERSION 1
+#define FRAMECAP_SLOTS 8  // 큐 칸 수 - 칸 하나가 4비트 화면 전체 크기 (240x240이면 28.8 KB)
+#define FRAMECAP_KEY 1    // 화면 전체 - 앞 프레임 없이 그릴 수 있음 (첫 프레임, 버린 프레임 다음)
+
+void framecap_init(void); // SNAKE_CAPTURE가 있으면 파일을 열고 기록 스레드 시작 - render_alloc 다음
+void framecap_set_tick(uint32_t tick); // 지금 화면에 반영된 틱 번호 (게임 루프가 틱마다)
+void framecap_frame(const uint8_t* fb, int stride, const DirtyList* d); // 넘긴 프레임 하나 (캡처 중이 아니면 바로 반환)
+void framecap_report(void); // 남은 프레임을 다 쓰고 닫은 뒤 통계 출력
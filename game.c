@@ -1,239 +1,397 @@
 #include "game.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-#include <bcm2835.h>
-
+#include "arena.h"
+#include "autopilot.h"
 #include "config.h"
-#include "font5x7.h"
+#include "framecap.h"
+#include "hal.h"
+#include "hud.h"
+#include "input.h"
+#include "lockstep.h"
+#include "metrics.h"
 #include "render.h"
-
-static GameState state = ST_MENU;
-static Point snake[GRID_W * GRID_H]; // 24 * 24 그리드 최대 크기
-static int snake_len = 0;
-static Dir dir = DIR_RIGHT; // 초기 이동 방향
-static Point foods[FOOD_COUNT]; // 음식마다의 좌표
-static int score = 0;
-
-static inline int pressed(uint8_t pin) { return bcm2835_gpio_lev(pin) == LOW; } // 버튼이 눌렸는지 확인
-static inline int eq(Point a, Point b) { return a.x == b.x && a.y == b.y; } // 두 점이 같은지 확인
-
-static void setup_inputs(void) { // 입력 초기화
-    uint8_t pins[] = {PIN_UP, PIN_DOWN, PIN_LEFT, PIN_RIGHT, PIN_CENTER, PIN_A, PIN_B};
-    for (int i = 0; i < (int)(sizeof(pins) / sizeof(pins[0])); i++) {
-        bcm2835_gpio_fsel(pins[i], BCM2835_GPIO_FSEL_INPT); // 입력으로 설정
-        bcm2835_gpio_set_pud(pins[i], BCM2835_GPIO_PUD_UP); // 풀업을 켜서 기본값을 HIGH로 설정
+#include "replay.h"
+#include "sched.h"
+#include "screens.h"
+#include "sim.h"
+#include "tiles.h"
+#include "versus.h"
+#include "wake.h"
+
+static GameMode mode = MODE_MENU;
+static Arena mem; // 격자 크기 배열 - game_init에서 한 번
+static GameState game; // 게임 규칙 상태 - 그리기는 game_step이 낸 이벤트로만 함
+static uint32_t ticks = 0; // game_step 호출 횟수 (벤치마크/재생용, 판이 바뀌어도 누적)
+static Sched sched; // 플레이 틱 스케줄러
+static int replaying = 0; // SNAKE_REPLAY로 기록된 입력을 재생 중
+static int autopilot = 0; // SNAKE_AUTOPILOT: 버튼 대신 autopilot_choose가 방향을 고름
+static long autopilot_games = 0; // 이만큼 판이 끝나면 종료 (0이면 끝없이 - 장시간 부하 시험)
+static long games_done = 0;
+static GameEvents events; // 이번 틱에 바뀐 칸
+static int versus = 0; // SNAKE_VS: 다른 기기/프로세스와 lockstep 대전
+static int vs_player = 0;
+static uint64_t vs_seed = 0;
+static uint8_t* vs_shown; // [SNAKE_CAP] 패널에 그려져 있는 칸 타일 (대전 모드)
+static uint8_t* vs_want;  // [SNAKE_CAP] 지금 상태의 칸 타일 (전체를 다시 비교할 때만)
+static uint32_t vs_seen;  // 그린 touch 기록 수 (VsState.touch_n)
+
+static void apply_events(const GameEvents* ev) { // 시뮬레이션이 낸 이벤트를 화면/통계에 반영
+    for (int i = 0; i < ev->n; i++) {
+        const GameEvent* e = &ev->e[i];
+        if (e->type == EV_CELL) {
+            if (e->p.y >= HUD_ROWS) draw_tile(e->p.x, e->p.y, (TileId)e->tile); // HUD 줄은 hud.c만 그림
+        } else if (e->type == EV_TURN) {
+            input_latency_record(e->t_us); // 엣지 -> 적용 지연
+        }
     }
 }
 
-static int snake_contains(Point p) { // 뱀이 특정 좌표 p를 포함하는지 확인
-    for (int i = 0; i < snake_len; i++) if (eq(snake[i], p)) return 1;
-    return 0;
+static uint32_t tick_period_ms(void) { // 점수에 따른 틱 주기 - 난이도
+    int ms = TICK_MS - game.score * TICK_SPEEDUP_MS;
+    return (uint32_t)(ms < TICK_MS_MIN ? TICK_MS_MIN : ms);
 }
 
-static void spawn_food_at(int idx) { // 음식 생성
-    Point p;
-    do {
-        p.x = rand() % GRID_W;
-        p.y = HUD_ROWS + (rand() % (GRID_H - HUD_ROWS)); // HUD_ROWS(점수벽) 이후 영역에 생성
-    } while (snake_contains(p)); // 뱀과 겹치지 않도록 함
-    foods[idx] = p; // 음식 좌표 저장
-    draw_cell(p.x, p.y, C_YELLOW); // 음식 그리기
-}
-
-static void render_score_bar(void) { // 점수 바 렌더링
-    int bar = score;
-    if (bar > GRID_W) bar = GRID_W; // 최대 길이 제한 현재 24
-    for (int x = 0; x < GRID_W; x++) draw_cell((uint8_t)x, 0, (x < bar) ? C_BLUE : C_BLACK); // 파란색: 점수, 검은색: 빈 공간
-    // 이렇게 매 틱마다 그려야 혹시나 음식/뱀이 점수 바와 겹칠 때 덮어쓰는 것을 방지할 수 있음
-}
-
-static void clear_screen_ui(void) { // 클리어 화면
-    fill_screen_both(C_GREEN); // 배경을 초록색으로 채움 실제 배경과 모니터미러링둘다 
-
-    int sdot = 4; // 문자 크기
-    int start_y = (ST7789_TFTHEIGHT - 7 * sdot) / 2;
-
-    draw_text_center_px("CLEAR!", start_y, sdot, C_WHITE); // 중앙에 "CLEAR!" 텍스트 그리기
+static void render_hud(void) { // HUD 갱신 - 바뀐 칸만 그려짐
+    HudState h = { game.score, 0 };
+    hud_update(&h);
 }
 
-static void reset_game(void) { // 게임 리셋
-    score = 0;
-    snake_len = 3;
-    dir = DIR_RIGHT;
-
-    uint8_t sy = HUD_ROWS + (GRID_H - HUD_ROWS) / 2;
-
-    // 뱀 초기 위치 설정 - 화면 중앙 가로줄 3칸
-    snake[0] = (Point){ GRID_W / 2, sy };
-    snake[1] = (Point){ (uint8_t)(GRID_W / 2 - 1), sy };
-    snake[2] = (Point){ (uint8_t)(GRID_W / 2 - 2), sy };
-
+static void start_round(void) { // 새 판 시작
+    events.n = 0;
+    game_reset(&game, &events);
     fill_screen_both(C_BLACK); // 화면 전체를 검은색으로 채움
-    for (int i = 0; i < snake_len; i++) draw_cell(snake[i].x, snake[i].y, C_GREEN); // 뱀 그리기
-
-    for (int i = 0; i < FOOD_COUNT; i++) { // 음식 생성
-        spawn_food_at(i);
-    }
-    render_score_bar(); //  점수 바 렌더링
-}
-
-static void menu_screen(void) { // 메뉴 화면
-    fill_screen_both(C_BLUE); // 배경을 파란색으로 채움
-
-    int sdot = 4;
-    int line_h = 7 * sdot + 6;
-    int start_y = (ST7789_TFTHEIGHT - line_h * 2) / 2;
-
-    draw_text_center_px("SNAKE", start_y, sdot, C_WHITE);
-    draw_text_center_px("START", start_y + line_h, sdot, C_WHITE);
+    hud_reset(); // HUD 칸도 지금은 모두 빈 칸
+    apply_events(&events); // 뱀/음식 그리기
+    render_hud(); //  점수 바 렌더링
 }
 
-static void gameover_screen(void) { // 게임 오버 화면
-    fill_screen_both(C_RED); // 배경을 빨간색으로 채움
-
-    int sdot = 4;
-    int line_h = 7 * sdot + 6;
-
-    int total_h = line_h * 2;
-    int start_y = (ST7789_TFTHEIGHT - total_h) / 2;
-
-    draw_text_center_px("GAME", start_y, sdot, C_WHITE);
-    draw_text_center_px("OVER", start_y + line_h, sdot, C_WHITE);
-}
-
-static void handle_input(void) { // 상태 별로 입력 처리
-    if (state == ST_MENU) { // 메뉴 상태
-        if (pressed(PIN_CENTER)) { // 중앙 버튼이 눌렸으면
-            bcm2835_delay(200); // 디바운스 딜레이
-            reset_game(); // 게임 리셋
-            state = ST_PLAY; // 게임 상태로 전환
+static void handle_key(const InputEvent* ev) { // 상태 별로 눌림 이벤트 처리
+    if (mode == MODE_MENU) { // 메뉴 상태
+        if (ev->key == KEY_CENTER) { // 중앙 버튼이 눌렸으면
+            start_round(); // 게임 리셋
+            mode = MODE_PLAY; // 게임 상태로 전환
         }
         return;
     }
 
-    if (state == ST_GAMEOVER) { // 게임 오버 상태
-        if (pressed(PIN_CENTER)) { // 중앙 버튼이 눌렸으면
-            bcm2835_delay(200); // 디바운스 딜레이
-            state = ST_MENU; //  메뉴 상태로 전환
-            menu_screen(); // 메뉴 화면 표시
+    if (mode == MODE_GAMEOVER || mode == MODE_CLEAR) { // 게임 오버/클리어 상태
+        if (ev->key == KEY_CENTER) { // 중앙 버튼이 눌렸으면
+            mode = MODE_MENU; //  메뉴 상태로 전환
+            screen_show(SCREEN_MENU); // 메뉴 화면 표시
         }
         return;
     }
 
-    if (state == ST_CLEAR) { // 클리어 상태
-        if (pressed(PIN_CENTER)) { // 중앙 버튼이 눌렸으면
-            bcm2835_delay(200); // 디바운스 딜레이
-            state = ST_MENU; // 메뉴 상태로 전환
-            menu_screen(); // 메뉴 화면 표시
-        }
-        return;
-    }
-
-    if (pressed(PIN_A)) { // A 버튼이 눌렸으면
-        bcm2835_delay(200); // 디바운스 딜레이
-        if (state == ST_PLAY) state = ST_PAUSE; // 일시정지 상태로 전환
-        else if (state == ST_PAUSE) state = ST_PLAY; // 플레이 상태로 전환
+    if (ev->key == KEY_A) { // A 버튼이 눌렸으면
+        if (mode == MODE_PLAY) mode = MODE_PAUSE; // 일시정지 상태로 전환
+        else if (mode == MODE_PAUSE) mode = MODE_PLAY; // 플레이 상태로 전환
         return;
     }
  
-    if (pressed(PIN_B)) { // B 버튼이 눌렸으면
-        bcm2835_delay(200); // 디바운스 딜레이
-        state = ST_MENU; // 메뉴 상태로 전환
-        menu_screen(); // 메뉴 화면 표시
+    if (ev->key == KEY_B) { // B 버튼이 눌렸으면
+        mode = MODE_MENU; // 메뉴 상태로 전환
+        screen_show(SCREEN_MENU); // 메뉴 화면 표시
         return;
     }
 
-    if (state != ST_PLAY) return; // 플레이 상태가 아니면 방향키 무시
+    if (mode != MODE_PLAY) return; // 플레이 상태가 아니면 방향키 무시
+
+    if (ev->key == KEY_UP) game_queue_turn(&game, DIR_UP, ev->t_us);
+    else if (ev->key == KEY_DOWN) game_queue_turn(&game, DIR_DOWN, ev->t_us);
+    else if (ev->key == KEY_LEFT) game_queue_turn(&game, DIR_LEFT, ev->t_us);
+    else if (ev->key == KEY_RIGHT) game_queue_turn(&game, DIR_RIGHT, ev->t_us);
+}
 
-    if (pressed(PIN_UP) && dir != DIR_DOWN) { // 위 버튼이 눌렸고 현재 방향이 아래가 아니면
-        dir = DIR_UP; bcm2835_delay(120); // 방향을 위로 변경, 딜레이로 너무 빠른 입력 방지
+static int replay_input(void) { // 재생: 다음 틱 전에 눌렸던 버튼들을 그대로 넣음. 넣은 수 반환
+    uint8_t key;
+    int n = 0;
+    while (replay_next(ticks, &key)) {
+        InputEvent ev = { hal_now_us(), (Key)key, 1 };
+        handle_key(&ev);
+        n++;
     }
-    else if (pressed(PIN_DOWN) && dir != DIR_UP) {
-        dir = DIR_DOWN; bcm2835_delay(120);
+    return n;
+}
+
+static void press(Key k) { // 자동 조종 입력 - 버튼과 같은 경로로 처리하고 기록도 됨
+    InputEvent ev = { hal_now_us(), k, 1 };
+    replay_record(ticks, (uint8_t)k);
+    handle_key(&ev);
+}
+
+static void autopilot_input(void) { // 플레이 중이면 다음 틱 방향, 메뉴/게임 오버면 중앙 버튼
+    static const Key keys[] = { [DIR_UP] = KEY_UP, [DIR_DOWN] = KEY_DOWN, [DIR_LEFT] = KEY_LEFT, [DIR_RIGHT] = KEY_RIGHT };
+    if (mode == MODE_PAUSE) return;
+    if (mode != MODE_PLAY) {
+        if (!autopilot_games || games_done < autopilot_games) press(KEY_CENTER);
+        return;
     }
-    else if (pressed(PIN_LEFT) && dir != DIR_RIGHT) {
-        dir = DIR_LEFT; bcm2835_delay(120);
+    if (game.turn_n > 0) return; // 이미 예약된 방향이 있음 (사람이 눌렀음)
+    Dir d = autopilot_choose(&game);
+    if (d != DIR_NONE && d != game.dir) press(keys[d]);
+}
+
+static void handle_input(void) { // 쌓인 입력 이벤트를 모두 처리 - 디바운스는 샘플러가 하므로 대기 없음
+    METRIC_SCOPE(MT_INPUT);
+    InputEvent ev;
+    if (replaying) {
+        replay_input();
+        return;
     }
-    else if (pressed(PIN_RIGHT) && dir != DIR_LEFT) {
-        dir = DIR_RIGHT; bcm2835_delay(120);
+    input_pump();
+    while (input_poll(&ev)) {
+        if (!ev.pressed) continue;
+        replay_record(ticks, (uint8_t)ev.key); // 기록 중이면 틱 번호와 함께 저장
+        handle_key(&ev);
     }
+    if (autopilot && mode != MODE_PLAY) autopilot_input();
 }
 
 static void tick_move(void) { // 뱀 이동 틱
-    Point head = snake[0]; // 현재 머리 위치
-    Point nh = head; // 새로운 머리 위치 계산
-
-    if (dir == DIR_UP) nh.y--; // 위로 이동
-    else if (dir == DIR_DOWN) nh.y++;
-    else if (dir == DIR_LEFT) nh.x--;
-    else if (dir == DIR_RIGHT) nh.x++;
+    METRIC_SCOPE(MT_SIM);
+    ticks++;
+    framecap_set_tick(ticks);
+    events.n = 0;
+    GameStatus st = game_step(&game, NULL, &events);
+    apply_events(&events);
+    if (autopilot && st != GAME_RUNNING) {
+        autopilot_game_over(game.score, st == GAME_CLEAR);
+        games_done++;
+    }
 
-    if (nh.x >= GRID_W || nh.y >= GRID_H || nh.y < HUD_ROWS) { // 벽 충돌 검사
-        state = ST_GAMEOVER;
-        gameover_screen();
+    if (st == GAME_DEAD) { // 벽/자기 몸 충돌
+        mode = MODE_GAMEOVER;
+        screen_show(SCREEN_GAMEOVER);
         return;
     }
-    if (snake_contains(nh)) { // 자기 몸과 충돌 검사
-        state = ST_GAMEOVER;
-        gameover_screen();
+    if (st == GAME_CLEAR) {
+        mode = MODE_CLEAR;
+        screen_show(SCREEN_CLEAR);
         return;
     }
-
-    // 음식 섭취 검사
-    int ate = -1;
-    for (int i = 0; i < FOOD_COUNT; i++) {
-        if (eq(nh, foods[i])) {
-            ate = i;
-            break;
-        }
+    for (int i = 0; i < events.n; i++) { // 먹었으면 빨라짐
+        if (events.e[i].type == EV_EAT) sched_set_period(&sched, tick_period_ms());
     }
+    render_hud(); // 점수 바 렌더링 - 점수가 안 바뀌면 아무것도 안 보냄
+}
 
-    // 점수 증가 및 클리어 검사
-    if (ate >= 0) score++;
-    if (score >= CLEAR_SCORE) {
-        state = ST_CLEAR;
-        clear_screen_ui();
-        return;
+static uint64_t pick_seed(void) { // SNAKE_SEED가 있으면 그 값, 없으면 시각으로
+    const char* s = getenv("SNAKE_SEED");
+    if (s) return strtoull(s, NULL, 0);
+    return ((uint64_t)time(NULL) << 20) ^ hal_now_us();
+}
+
+static void replay_loop(void) { // 재생: 대기 없이 틱마다 바로 진행하고 그림 - 최대 속도
+    while (1) {
+        int fed = replay_input();
+        if (mode == MODE_PLAY) {
+            if (ticks >= replay_end_tick()) break; // 기록한 지점까지 왔음
+            tick_move();
+        } else if (!fed) {
+            break; // 메뉴/게임 오버에서 더 넣을 입력이 없으면 끝
+        }
+        if (!render_present()) break;
+        metrics_poll(ticks);
     }
+    if (replay_pending()) printf("replay: stopped at tick %u with events left (desync?)\n", ticks);
+}
 
-    // 뱀 이동 처리
-    Point tail = snake[snake_len - 1];
-    if (ate < 0) draw_cell(tail.x, tail.y, C_BLACK); // 꼬리 지우기
-    else snake_len++; // 음식 먹었으면 길이 증가
+static void draw_vs_cell(int c, uint8_t t) {
+    if (c < HUD_ROWS * GRID_W || t == vs_shown[c]) return; // HUD 줄은 hud.c만 그림
+    vs_shown[c] = t;
+    draw_tile((uint16_t)(c % GRID_W), (uint16_t)(c / GRID_W), (TileId)t);
+}
 
-    for (int i = snake_len - 1; i > 0; i--) snake[i] = snake[i - 1]; // 몸통 이동
-    snake[0] = nh; // 머리 위치 갱신
+static void draw_versus(void) { // 지난번 뒤로 touch에 나온 칸만 타일을 다시 구해 그림 - 되감기로 되돌린 칸도 touch에 남음
+    const VsState* v = lockstep_state();
+    if (v->touch_n - vs_seen > VS_TOUCH_RING) { // 기록이 넘침 (판 시작, 오래 밀림) - 전체 비교
+        vs_tiles(v, vs_want);
+        for (int c = 0; c < SNAKE_CAP; c++) draw_vs_cell(c, vs_want[c]);
+    } else {
+        for (uint32_t i = vs_seen; i != v->touch_n; i++) {
+            int c = v->touch[i % VS_TOUCH_RING];
+            draw_vs_cell(c, vs_tile_at(v, c));
+        }
+    }
+    vs_seen = v->touch_n;
+    HudState h = { v->s[0].score, v->s[1].score }; // 양쪽 화면이 같도록 0번이 항상 왼쪽
+    hud_update(&h);
+}
 
-    draw_cell(nh.x, nh.y, C_GREEN); // 새로운 머리 그리기
+static int versus_input(void) { // 방향 버튼은 lockstep으로 보내고, B는 대전 그만두기. 그만두면 0
+    static const Dir dirs[] = { [KEY_UP] = DIR_UP, [KEY_DOWN] = DIR_DOWN, [KEY_LEFT] = DIR_LEFT, [KEY_RIGHT] = DIR_RIGHT };
+    METRIC_SCOPE(MT_INPUT);
+    InputEvent ev;
+    int go = 1;
+    input_pump();
+    while (input_poll(&ev)) {
+        if (!ev.pressed) continue;
+        if (ev.key <= KEY_RIGHT) lockstep_local_input(dirs[ev.key]);
+        else if (ev.key == KEY_B) go = 0;
+    }
+    return go;
+}
 
-    if (ate >= 0) { // 음식 먹었으면
-        spawn_food_at(ate); // 새로운 음식 생성
+static void versus_loop(void) { // 대전: 틱은 스케줄러 마감마다, 단 상대 입력이 너무 밀리면 멈춰서 기다림 (stall)
+    if (!lockstep_handshake(&vs_seed)) {
+        printf("versus: no peer\n");
+        return;
+    }
+    mode = MODE_PLAY;
+    fill_screen_both(C_BLACK);
+    hud_reset();
+    memset(vs_shown, TILE_EMPTY, SNAKE_CAP);
+    sched_set_period(&sched, TICK_MS); // 속도 고정 - 양쪽 틱 주기가 같아야 함
+    sched_resync(&sched);
+
+    int owed = 0; // 마감이 지났는데 아직 못 한 틱
+    while (1) {
+        if (!versus_input()) break;
+        lockstep_poll(); // 받은 입력 반영 (예측이 틀렸으면 되감기)
+        owed += sched_due(&sched);
+        if (owed > SCHED_MAX_CATCHUP) owed = SCHED_MAX_CATCHUP;
+        {
+            METRIC_SCOPE(MT_SIM);
+            while (owed > 0 && lockstep_advance()) {
+                owed--;
+                ticks++;
+            }
+        }
+        framecap_set_tick(lockstep_state()->tick); // 되감기 뒤 다시 계산한 상태의 틱
+        draw_versus();
+        if (!render_present()) break;
+        if (lockstep_result() != VS_RUNNING || lockstep_peer_gone() || hal_quit_requested()) break;
+        metrics_poll(ticks);
+
+        METRIC_SCOPE(MT_WAIT);
+        if (owed > 0) lockstep_wait(INPUT_POLL_MS); // stall: 상대 패킷이 오면 바로 깸 (가상 시계도 멈춰 있음)
+        else sched_wait(&sched, INPUT_POLL_MS);
+    }
+    lockstep_close(); // 상대가 마지막 틱을 확정할 수 있게 남은 입력을 보내고 종료 알림
+
+    VsStatus r = lockstep_result(), won = vs_player ? VS_WIN1 : VS_WIN0;
+    const char* msg = r == VS_RUNNING ? "stopped" : r == VS_DRAW ? "draw" : r == won ? "win" : "lose";
+    printf("versus: player %d %s at tick %u\n", vs_player, msg, lockstep_state()->tick);
+    if (r == VS_RUNNING) return;
+    mode = r == won ? MODE_CLEAR : MODE_GAMEOVER;
+    screen_show(r == VS_DRAW ? SCREEN_DRAW : mode == MODE_CLEAR ? SCREEN_WIN : SCREEN_GAMEOVER);
+    render_present();
+    while (hal_realtime() && !hal_quit_requested()) { // 결과 화면은 아무 버튼이나 누를 때까지 (호스트 백엔드는 바로 끝냄)
+        InputEvent ev;
+        int pressed = 0;
+        input_pump();
+        while (input_poll(&ev)) pressed |= ev.pressed;
+        if (pressed || !render_present()) break;
+        wake_idle(0);
     }
-    render_score_bar(); // 점수 바 렌더링
 }
 
 // 얘넨 static 아님
 
 int game_init(void) { // 게임 초기화
-    setup_inputs();
-    srand((unsigned)time(NULL)); // 랜덤 시드 설정 - 먹이랜덤위치
-    menu_screen();
+    const char* play = getenv("SNAKE_REPLAY");
+    const char* rec = getenv("SNAKE_RECORD");
+    uint64_t seed = pick_seed();
+
+    if (play) { // 재생: 버튼 대신 파일의 입력, 시드도 파일 것
+        if (!replay_open(play, &seed)) return 0;
+        replaying = 1;
+    } else if (!input_start()) { // 버튼 샘플러 시작
+        return 0;
+    } else {
+        wake_open(); // 실패해도 주기적으로 깨는 대기로 계속
+    }
+    if (rec && !play && !replay_record_open(rec, seed)) return 0; // 재생 중에는 기록하지 않음
+    const char* vs = getenv("SNAKE_VS");
+    if (vs && !play) { // 대전: 값은 플레이어 번호 (0이 시드를 정함)
+        const char* d = getenv("SNAKE_VS_DELAY");
+        vs_player = atoi(vs) ? 1 : 0;
+        if (!lockstep_open(vs_player, getenv("SNAKE_VS_BIND"), getenv("SNAKE_VS_PEER"), d ? atoi(d) : LOCKSTEP_DELAY)) return 0;
+        versus = 1;
+        vs_seed = seed;
+    }
+    const char* ap = getenv("SNAKE_AUTOPILOT");
+    if (ap && !play) { // 자동 조종: 값은 판 수 (0이면 끝없이)
+        autopilot = 1;
+        autopilot_games = strtol(ap, NULL, 10);
+    }
+    if (!arena_init(&mem, game_state_bytes() + 2 * arena_round(SNAKE_CAP)) || !game_state_alloc(&game, &mem)) return 0;
+    vs_shown = arena_alloc(&mem, SNAKE_CAP);
+    vs_want = arena_alloc(&mem, SNAKE_CAP);
+    game_state_init(&game, seed); // 랜덤 시드 설정 - 먹이랜덤위치
+    sched_start(&sched, tick_period_ms());
+    tiles_init(); // 칸 타일 아틀라스
+    if (!screens_init()) return 0; // 전체 화면들 미리 그려 두기
+    screen_show(SCREEN_MENU);
     return 1;
 }
 
 void game_loop(void) {
+    if (versus) {
+        versus_loop();
+        input_stop();
+        wake_close();
+        return;
+    }
+    if (replaying) {
+        replay_loop();
+        return;
+    }
     while (1) {
+        int was_idle = mode != MODE_PLAY;
         handle_input();
 
-        if (state == ST_PLAY) {
-            tick_move();
-            bcm2835_delay(120); // 게임 속도 조절
+        int ran = 0; // 이번 루프에서 실행한 틱 수
+        if (mode == MODE_PLAY) {
+            if (was_idle) sched_resync(&sched); // 멈춘 동안 밀린 틱은 없음 - 버튼을 기다리며 오래 잤을 수 있음
+            // 틱은 절대 마감 시각 기준으로만 진행 - 입력/SPI/미러 시간이 속도에 섞이지 않음
+            int n = sched_due(&sched);
+            for (; ran < n && mode == MODE_PLAY; ran++) {
+                if (autopilot) autopilot_input(); // 틱마다 바로 전 상태를 보고 결정
+                tick_move();
+            }
         } else {
-            bcm2835_delay(50);
+            sched_set_period(&sched, tick_period_ms());
         }
 
-        if (!render_present()) break;  // q 누르면 탈출
+        if ((mode != MODE_PLAY || ran) && !render_present()) break;  // q 누르면 탈출
+        if (hal_quit_requested()) break; // 호스트 백엔드: 입력 스크립트 종료
+        if (autopilot_games && games_done >= autopilot_games) break; // 자동 조종: 정한 판 수를 다 했음
+
+        metrics_poll(ticks);
+
+        METRIC_SCOPE(MT_WAIT);
+        if (mode == MODE_PLAY) wake_tick(sched.next_us); // 다음 틱 마감 또는 입력까지 대기
+        else wake_idle(autopilot); // 메뉴/일시정지/게임 오버: 버튼이 눌릴 때까지
+    }
+    input_stop(); // 샘플러 스레드 종료
+    wake_close();
+    replay_record_close(ticks, game.score);
+}
+
+void game_report(void) {
+    if (replaying) {
+        int want = replay_end_score();
+        printf("replay: %u ticks, score %d (recorded %d) %s\n", ticks, game.score, want,
+               want < 0 || want == game.score ? "ok" : "MISMATCH");
+        return;
     }
+    sched_report(&sched);
+    input_report();
+    wake_report();
+    if (autopilot) autopilot_report();
+    if (versus) lockstep_report();
+}
+
+int game_replaying(void) {
+    return replaying;
+}
+
+uint32_t game_ticks(void) {
+    return ticks;
 }
@@ -2,9 +2,12 @@
 
 #include <stdint.h>
 
-typedef struct { uint8_t x, y; } Point; // 격자 좌표 그리드 24*24쓸거임
-typedef enum { DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT } Dir; // 이동 방향
-typedef enum { ST_MENU, ST_PLAY, ST_PAUSE, ST_GAMEOVER, ST_CLEAR } GameState; // 게임 상태
+#include "sim.h"
+
+typedef enum { MODE_MENU, MODE_PLAY, MODE_PAUSE, MODE_GAMEOVER, MODE_CLEAR } GameMode; // 화면/진행 상태
 
 int game_init(void);
 void game_loop(void);
+uint32_t game_ticks(void); // 지금까지 실행한 tick_move 횟수
+void game_report(void); // 틱 지연 통계 출력 (재생이면 재생 결과)
+int game_replaying(void); // SNAKE_REPLAY로 기록된 입력을 재생 중인지
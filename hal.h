@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+// GPIO/SPI/시간 하드웨어 추상화 계층
+// 백엔드는 빌드할 때 하나만 링크함
+//  - hal_bcm2835.c: 라즈베리파이 실제 하드웨어 (bcm2835 라이브러리, root 필요)
+//  - hal_spidev.c : 리눅스 커널 드라이버 (spidev + GPIO 문자 장치, root 불필요, SPI 쓰기를 모아서 전송)
+//  - hal_host.c   : 리눅스 PC용 헤드리스 백엔드 (패널을 메모리 이미지로 흉내, 입력은 스크립트)
+
+#define HAL_LOW  0
+#define HAL_HIGH 1
+
+int hal_init(void);   // 0이면 실패
+void hal_close(void);
+int hal_realtime(void); // 1이면 실제 시계, 0이면 가상 시계(호스트 백엔드)
+
+void hal_gpio_output(uint8_t pin);       // 출력 핀으로 설정
+void hal_gpio_input_pullup(uint8_t pin); // 풀업 입력 핀으로 설정
+void hal_gpio_write(uint8_t pin, int high);
+int hal_gpio_read(uint8_t pin);          // HAL_LOW 또는 HAL_HIGH
+int hal_gpio_is_output(uint8_t pin);     // 1이면 이미 출력 핀 - 이전 실행이 설정해 둔 상태 (웜 재시작 감지). spidev는 지난 실행을 알 수 없어 이 프로세스가 쥔 핀만
+int hal_gpio_edge_fd(uint8_t pin);       // 풀업 입력 핀의 엣지 이벤트 fd (레벨이 바뀌면 읽을 수 있음). 지원 안 하면 -1
+void hal_gpio_edge_ack(uint8_t pin);     // 쌓인 엣지 이벤트를 버림 - 다음 엣지까지 fd가 다시 조용해짐
+
+void hal_spi_begin(void);
+void hal_spi_end(void);
+void hal_spi_write(const uint8_t* buf, uint32_t len); // 블로킹 전송 (모아서 보내는 백엔드는 hal_spi_flush까지 늦어질 수 있음)
+void hal_spi_flush(void); // 모아 둔 SPI 쓰기를 지금 보냄 - 대기 전, 프레임 끝
+
+void hal_delay_ms(uint32_t ms);
+uint64_t hal_now_us(void); // 단조 증가 시계 (마이크로초)
+void hal_sleep_until_us(uint64_t t_us); // hal_now_us 기준 절대 시각까지 잠
+
+int hal_quit_requested(void); // 1이면 종료 요청 (호스트 백엔드의 입력 스크립트 종료 등)
+
+// 호스트 백엔드 전용: 흉내 낸 패널 유리에 보이는 화면 (ST7789_TFTWIDTH x ST7789_TFTHEIGHT RGB565), 다른 백엔드는 NULL
+const uint16_t* hal_host_panel(void);
@@ -0,0 +1,133 @@
+#include "hal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/gpio.h>
+
+#include <bcm2835.h>
+
+// 핀 읽기/쓰기와 SPI는 /dev/mem(bcm2835 라이브러리)으로 하고, 버튼 엣지만 GPIO 문자 장치에서 받음
+//  SNAKE_GPIOCHIP=경로 : 엣지를 받을 GPIO 칩 (기본 /dev/gpiochip0, hal_spidev.c와 같음). 열 수 없으면 샘플러가 주기적으로 읽음
+
+#define GPIO_LINES 64
+
+static int chip_fd = -1;
+static int edge_fd[GPIO_LINES]; // 입력 핀마다 엣지 이벤트 라인 요청 fd (-1이면 없음)
+
+int hal_init(void) {
+    for (int i = 0; i < GPIO_LINES; i++) edge_fd[i] = -1;
+    return bcm2835_init(); // /dev/mem 접근 - root 필요
+}
+
+void hal_close(void) {
+    for (int i = 0; i < GPIO_LINES; i++) {
+        if (edge_fd[i] >= 0) close(edge_fd[i]);
+        edge_fd[i] = -1;
+    }
+    if (chip_fd >= 0) close(chip_fd);
+    chip_fd = -1;
+    bcm2835_close();
+}
+
+static void edge_request(uint8_t pin) { // hal_spidev.c hal_gpio_input_pullup과 같은 요청 - 실패하면 그 핀만 주기적으로 읽음
+    if (chip_fd < 0) {
+        const char* s = getenv("SNAKE_GPIOCHIP");
+        chip_fd = open(s ? s : "/dev/gpiochip0", O_RDWR | O_CLOEXEC);
+        if (chip_fd < 0) {
+            perror("gpiochip (button edges)");
+            return;
+        }
+    }
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+    req.offsets[0] = pin;
+    req.num_lines = 1;
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_BIAS_PULL_UP | GPIO_V2_LINE_FLAG_EDGE_RISING |
+                       GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    strcpy(req.consumer, "snake");
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+        perror("GPIO_V2_GET_LINE_IOCTL");
+        return;
+    }
+    fcntl(req.fd, F_SETFL, fcntl(req.fd, F_GETFL) | O_NONBLOCK); // hal_gpio_edge_ack가 막히지 않게
+    edge_fd[pin] = req.fd;
+}
+
+int hal_realtime(void) { return 1; }
+
+void hal_gpio_output(uint8_t pin) {
+    bcm2835_gpio_fsel(pin, BCM2835_GPIO_FSEL_OUTP);
+}
+
+void hal_gpio_input_pullup(uint8_t pin) {
+    bcm2835_gpio_fsel(pin, BCM2835_GPIO_FSEL_INPT); // 입력으로 설정
+    bcm2835_gpio_set_pud(pin, BCM2835_GPIO_PUD_UP); // 풀업을 켜서 기본값을 HIGH로 설정
+    if (pin < GPIO_LINES && edge_fd[pin] < 0) edge_request(pin); // 레벨은 계속 bcm2835_gpio_lev로 읽음
+}
+
+void hal_gpio_write(uint8_t pin, int high) {
+    if (high) bcm2835_gpio_set(pin);
+    else bcm2835_gpio_clr(pin);
+}
+
+int hal_gpio_read(uint8_t pin) {
+    return bcm2835_gpio_lev(pin) == LOW ? HAL_LOW : HAL_HIGH;
+}
+
+int hal_gpio_is_output(uint8_t pin) { // 기능 선택 레지스터(GPFSEL)를 직접 읽음 - 핀마다 3비트, 레지스터 하나에 10핀
+    volatile uint32_t* reg = bcm2835_gpio + BCM2835_GPFSEL0 / 4 + pin / 10;
+    return ((bcm2835_peri_read(reg) >> ((pin % 10) * 3)) & 7) == BCM2835_GPIO_FSEL_OUTP;
+}
+
+int hal_gpio_edge_fd(uint8_t pin) { // /dev/mem에는 기다릴 fd가 없어서 문자 장치의 라인 fd
+    return pin < GPIO_LINES ? edge_fd[pin] : -1;
+}
+
+void hal_gpio_edge_ack(uint8_t pin) {
+    struct gpio_v2_line_event ev[16];
+    if (pin < GPIO_LINES && edge_fd[pin] >= 0) {
+        while (read(edge_fd[pin], ev, sizeof(ev)) > 0) {}
+    }
+}
+
+void hal_spi_begin(void) {
+    bcm2835_spi_begin();
+    bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_8);
+}
+
+void hal_spi_end(void) {
+    bcm2835_spi_end();
+}
+
+void hal_spi_write(const uint8_t* buf, uint32_t len) {
+    if (len == 1) bcm2835_spi_transfer(buf[0]);
+    else bcm2835_spi_writenb((const char*)buf, len);
+}
+
+void hal_spi_flush(void) {} // 바로 보내므로 모아 둔 것 없음
+
+void hal_delay_ms(uint32_t ms) {
+    bcm2835_delay(ms);
+}
+
+uint64_t hal_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+void hal_sleep_until_us(uint64_t t_us) {
+    struct timespec ts = { (time_t)(t_us / 1000000u), (long)(t_us % 1000000u) * 1000L };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {} // 시그널로 깨면 다시 잠
+}
+
+int hal_quit_requested(void) { return 0; }
+
+const uint16_t* hal_host_panel(void) { return NULL; }
@@ -0,0 +1,235 @@
+#include "hal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+// 헤드리스 호스트 백엔드
+//  SNAKE_INPUT=파일  : 입력 스크립트. 한 줄에 "<ms> <키> [누르는시간ms]", 키는 U D L R C A B
+//  SNAKE_MAX_MS=ms   : 가상 시간이 이 값을 넘으면 종료 요청 (기본: 스크립트 끝 + 1초, 스크립트 없으면 10초, 0이면 제한 없음)
+//  SNAKE_DUMP=파일   : 종료할 때 패널 이미지를 PPM으로 저장
+//  SNAKE_WARM=1      : 이전 실행이 RST를 출력 HIGH로 둔 채 끝난 것처럼 시작 (웜 재시작 - 하드웨어 리셋 생략)
+// 딜레이는 가상 시계만 진행시키므로 실제로는 쉬지 않고 최대 속도로 돈다
+// 패널은 컨트롤러 메모리 전체(240x320)를 MADCTL 회전/반전까지 흉내 내고, 유리(panel_w x panel_h)에 보이는 부분만 꺼냄
+
+#define HOST_MAX_PRESSES 4096
+#define HOST_DEFAULT_HOLD_MS 100 // 사람이 버튼을 누르는 정도의 시간
+
+typedef struct { uint64_t t0, t1; uint8_t pin; } Press; // [t0, t1) 동안 pin이 LOW
+
+static Press presses[HOST_MAX_PRESSES];
+static int press_n = 0;
+static uint64_t now_us = 0;
+static uint64_t max_us = 0;
+
+static uint8_t dc_level = HAL_HIGH;
+static uint64_t out_pins = 0;  // 출력으로 설정된 핀 (비트 = 핀 번호)
+static uint64_t out_level = 0; // 출력 핀의 마지막으로 쓴 값
+
+// 패널 흉내: 명령/파라미터를 해석해서 메모리 이미지에 픽셀을 씀
+static uint16_t ram[ST7789_RAM_W * ST7789_RAM_H]; // 컨트롤러 메모리 - [행][열]
+static uint16_t view[ST7789_RAM_W * ST7789_RAM_H]; // 유리에 보이는 화면 (hal_host_panel)
+static uint8_t cmd = ST7789_NOP;
+static uint8_t params[4];
+static int param_n = 0;
+static uint16_t xs, xe = ST7789_RAM_W - 1, ys, ye = ST7789_RAM_H - 1;
+static uint16_t cx, cy; // RAMWR 커서 (MADCTL 적용 전 주소)
+static uint8_t colmod = ST7789_COLMOD_16BIT;
+static uint8_t madctl = 0;
+static uint8_t pend[3]; // 아직 픽셀이 안 된 RAMWR 바이트
+static int pend_n = 0;
+
+static int key_pin(char k) {
+    switch (k) {
+    case 'U': return PIN_UP;
+    case 'D': return PIN_DOWN;
+    case 'L': return PIN_LEFT;
+    case 'R': return PIN_RIGHT;
+    case 'C': return PIN_CENTER;
+    case 'A': return PIN_A;
+    case 'B': return PIN_B;
+    }
+    return -1;
+}
+
+static void load_script(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) { printf("hal_host: cannot open %s\n", path); return; }
+
+    char line[128];
+    uint64_t last = 0;
+    while (fgets(line, sizeof(line), f) && press_n < HOST_MAX_PRESSES) {
+        unsigned long ms, hold = HOST_DEFAULT_HOLD_MS;
+        char key;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%lu %c %lu", &ms, &key, &hold) < 2) continue;
+        int pin = key_pin(key);
+        if (pin < 0) continue;
+        presses[press_n++] = (Press){ ms * 1000u, (ms + hold) * 1000u, (uint8_t)pin };
+        if ((ms + hold) * 1000u > last) last = (ms + hold) * 1000u;
+    }
+    fclose(f);
+    max_us = last + 1000000u;
+}
+
+int hal_init(void) {
+    const char* s = getenv("SNAKE_INPUT");
+    max_us = 10000000u;
+    if (s) load_script(s);
+    s = getenv("SNAKE_MAX_MS");
+    if (s) max_us = strtoull(s, NULL, 10) * 1000u;
+    s = getenv("SNAKE_WARM");
+    if (s && atoi(s)) { // 이전 실행이 남긴 핀 상태
+        out_pins |= 1ull << TFT_RST | 1ull << TFT_DC;
+        out_level |= 1ull << TFT_RST;
+    }
+    for (int i = 0; i < ST7789_RAM_W * ST7789_RAM_H; i++) ram[i] = 0xF81F; // 리셋 직후/이전 실행의 패널 RAM - 첫 프레임이 전부 덮어야 함
+    return 1;
+}
+
+static void dump_ppm(const char* path) {
+    const uint16_t* panel = hal_host_panel();
+    FILE* f = fopen(path, "wb");
+    if (!f) return;
+    fprintf(f, "P6\n%d %d\n255\n", ST7789_TFTWIDTH, ST7789_TFTHEIGHT);
+    for (int i = 0; i < ST7789_TFTWIDTH * ST7789_TFTHEIGHT; i++) {
+        uint16_t c = panel[i];
+        uint8_t rgb[3] = {
+            (uint8_t)(((c >> 11) & 0x1F) << 3),
+            (uint8_t)(((c >> 5) & 0x3F) << 2),
+            (uint8_t)((c & 0x1F) << 3),
+        };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+}
+
+void hal_close(void) {
+    const char* s = getenv("SNAKE_DUMP");
+    if (s) dump_ppm(s);
+}
+
+int hal_realtime(void) { return 0; }
+
+void hal_gpio_output(uint8_t pin) { out_pins |= 1ull << pin; }
+
+void hal_gpio_input_pullup(uint8_t pin) { (void)pin; }
+
+void hal_gpio_write(uint8_t pin, int high) {
+    if (high) out_level |= 1ull << pin;
+    else out_level &= ~(1ull << pin);
+    if (pin == TFT_DC) dc_level = high ? HAL_HIGH : HAL_LOW;
+}
+
+int hal_gpio_read(uint8_t pin) {
+    if (out_pins >> pin & 1) return (out_level >> pin & 1) ? HAL_HIGH : HAL_LOW;
+    for (int i = 0; i < press_n; i++) {
+        if (presses[i].pin == pin && now_us >= presses[i].t0 && now_us < presses[i].t1) return HAL_LOW;
+    }
+    return HAL_HIGH; // 풀업 - 안 눌림
+}
+
+int hal_gpio_is_output(uint8_t pin) { return (int)(out_pins >> pin & 1); }
+
+int hal_gpio_edge_fd(uint8_t pin) { (void)pin; return -1; } // 입력은 가상 시계로 input_pump가 샘플링
+
+void hal_gpio_edge_ack(uint8_t pin) { (void)pin; }
+
+void hal_spi_begin(void) {}
+
+void hal_spi_end(void) {}
+
+static void panel_pixel(uint16_t c) { // 커서 위치에 픽셀 쓰고 창 안에서 커서 진행
+    int col = cx, row = cy; // MADCTL: 행/열 교환 다음에 각 축 반전 (메모리 기준)
+    if (madctl & ST7789_MADCTL_MV) { col = cy; row = cx; }
+    if (madctl & ST7789_MADCTL_MX) col = ST7789_RAM_W - 1 - col;
+    if (madctl & ST7789_MADCTL_MY) row = ST7789_RAM_H - 1 - row;
+    if (col >= 0 && col < ST7789_RAM_W && row >= 0 && row < ST7789_RAM_H) ram[row * ST7789_RAM_W + col] = c;
+    if (cx++ >= xe) {
+        cx = xs;
+        if (cy++ >= ye) cy = ys;
+    }
+}
+
+static uint16_t from444(uint8_t r, uint8_t g, uint8_t b) { // 4비트 채널을 RGB565로 넓힘
+    return (uint16_t)(((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3));
+}
+
+static void panel_byte(uint8_t b) {
+    if (dc_level == HAL_LOW) { // 명령
+        cmd = b;
+        param_n = 0;
+        pend_n = 0;
+        if (cmd == ST7789_RAMWR) { cx = xs; cy = ys; }
+        return;
+    }
+    if (cmd == ST7789_RAMWR) {
+        pend[pend_n++] = b;
+        if (colmod == ST7789_COLMOD_12BIT) { // RGB444 두 픽셀 = 3바이트
+            if (pend_n < 3) return;
+            panel_pixel(from444(pend[0] >> 4, pend[0] & 0x0F, pend[1] >> 4));
+            panel_pixel(from444(pend[1] & 0x0F, pend[2] >> 4, pend[2] & 0x0F));
+        } else { // RGB565 big-endian
+            if (pend_n < 2) return;
+            panel_pixel((uint16_t)((pend[0] << 8) | pend[1]));
+        }
+        pend_n = 0;
+        return;
+    }
+    if (cmd == ST7789_COLMOD) {
+        colmod = b;
+        return;
+    }
+    if (cmd == ST7789_MADCTL) {
+        madctl = b;
+        return;
+    }
+    if (cmd == ST7789_CASET || cmd == ST7789_RASET) {
+        if (param_n < 4) params[param_n++] = b;
+        if (param_n == 4) {
+            uint16_t a0 = (uint16_t)((params[0] << 8) | params[1]);
+            uint16_t a1 = (uint16_t)((params[2] << 8) | params[3]);
+            if (cmd == ST7789_CASET) { xs = a0; xe = a1; }
+            else { ys = a0; ye = a1; }
+        }
+    }
+}
+
+void hal_spi_write(const uint8_t* buf, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) panel_byte(buf[i]);
+}
+
+void hal_spi_flush(void) {}
+
+void hal_delay_ms(uint32_t ms) {
+    now_us += (uint64_t)ms * 1000u;
+}
+
+uint64_t hal_now_us(void) {
+    return now_us;
+}
+
+void hal_sleep_until_us(uint64_t t_us) {
+    if (t_us > now_us) now_us = t_us;
+}
+
+int hal_quit_requested(void) {
+    return max_us && now_us >= max_us;
+}
+
+const uint16_t* hal_host_panel(void) {
+    // 유리는 메모리 왼쪽 위 panel_w x panel_h - 보는 사람 기준 좌표는 유리 크기만으로 회전/반전 (st7789.c의 오프셋을 쓰지 않음)
+    int pw = st7789_geom.panel_w, ph = st7789_geom.panel_h;
+    int w = (madctl & ST7789_MADCTL_MV) ? ph : pw;
+    for (int r = 0; r < ph; r++) {
+        for (int c = 0; c < pw; c++) {
+            int u = (madctl & ST7789_MADCTL_MX) ? pw - 1 - c : c;
+            int v = (madctl & ST7789_MADCTL_MY) ? ph - 1 - r : r;
+            int x = (madctl & ST7789_MADCTL_MV) ? v : u, y = (madctl & ST7789_MADCTL_MV) ? u : v;
+            view[y * w + x] = ram[r * ST7789_RAM_W + c];
+        }
+    }
+    return view;
+}
@@ -0,0 +1,226 @@
+#include "hal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+#include "st7789.h"
+
+// 리눅스 커널 드라이버 백엔드 - /dev/mem 대신 spidev + GPIO 문자 장치 (spi/gpio 그룹이면 root 불필요)
+//  SNAKE_SPIDEV=경로   : SPI 장치 (기본 /dev/spidev0.0, CE0 = TFT_CS)
+//  SNAKE_GPIOCHIP=경로 : GPIO 칩 (기본 /dev/gpiochip0)
+//
+// hal_spi_write는 바로 보내지 않고 메시지 버퍼에 모아 두었다가 SPI_IOC_MESSAGE 한 번으로 보냄
+// DC는 spidev 전송 도중에 바꿀 수 없는 별도 GPIO이므로, 메시지 하나는 DC 레벨이 같은 구간까지만
+// (한 메시지 안의 바이트는 모두 이어져 있어 전송 조각도 하나): DC/RST가 바뀔 때, 버퍼가 찰 때, hal_spi_flush에서 보냄
+// 창 하나 갱신 = CASET | 주소 | RASET | 주소 | RAMWR | 픽셀 전체 - ioctl 6번 (픽셀은 bufsiz 단위로 나뉨)
+// SPI를 쓰는 스레드(초기화 후에는 render.c 전송 스레드)만 보내므로 락 없음
+
+#define SPIDEV_HZ 32000000u      // bcm2835 백엔드의 분주비 8과 비슷한 속도
+#define SPIDEV_BUF_MAX 65536u    // 메시지 버퍼 크기 - 실제 상한은 커널의 spidev bufsiz
+#define GPIO_LINES 64
+
+static int chip_fd = -1;
+static int line_fd[GPIO_LINES]; // 핀마다 라인 요청 fd (-1이면 아직 요청 안 함)
+static int dc_level = -1;        // DC에 마지막으로 쓴 값 - 같으면 ioctl 생략
+static uint64_t edge_pins = 0;   // 엣지 이벤트를 켠 핀 (비트마스크)
+static uint64_t out_pins = 0;    // 이 프로세스가 출력으로 요청한 핀 (비트마스크)
+
+static int spi_fd = -1;
+static uint32_t spi_bufsiz = 4096; // 커널 기본값 - /sys/module/spidev/parameters/bufsiz로 갱신
+static uint8_t msg_buf[SPIDEV_BUF_MAX];
+static uint32_t msg_len = 0;
+static uint32_t stat_msgs = 0, stat_dc = 0; // SPI ioctl 수, DC 전환 수
+static uint64_t stat_bytes = 0;
+
+int hal_init(void) {
+    const char* s = getenv("SNAKE_GPIOCHIP");
+    for (int i = 0; i < GPIO_LINES; i++) line_fd[i] = -1;
+    chip_fd = open(s ? s : "/dev/gpiochip0", O_RDWR | O_CLOEXEC);
+    if (chip_fd < 0) {
+        perror("gpiochip");
+        return 0;
+    }
+    return 1;
+}
+
+void hal_close(void) {
+    for (int i = 0; i < GPIO_LINES; i++) {
+        if (line_fd[i] >= 0) close(line_fd[i]); // 요청을 닫은 뒤의 핀 상태는 드라이버 마음 - 마지막 값이 남는다는 보장 없음
+    }
+    if (chip_fd >= 0) close(chip_fd);
+    printf("spidev: %u messages (%.1f bytes/message), %u DC switches, bufsiz %u\n", stat_msgs,
+           stat_msgs ? (double)stat_bytes / stat_msgs : 0.0, stat_dc, spi_bufsiz);
+}
+
+int hal_realtime(void) { return 1; }
+
+static void spi_send(void) { // 모아 둔 바이트를 메시지 하나로 전송 - 크면 커널이 DMA로 보냄
+    if (msg_len == 0) return;
+    struct spi_ioc_transfer t;
+    memset(&t, 0, sizeof(t));
+    t.tx_buf = (uint64_t)(uintptr_t)msg_buf;
+    t.len = msg_len;
+    t.speed_hz = SPIDEV_HZ;
+    t.bits_per_word = 8;
+    if (ioctl(spi_fd, SPI_IOC_MESSAGE(1), &t) < 0) perror("SPI_IOC_MESSAGE");
+    stat_msgs++;
+    stat_bytes += msg_len;
+    msg_len = 0;
+}
+
+static int line_request(uint8_t pin, uint64_t flags, int value) { // 핀 하나를 flags로 요청 (이미 있으면 설정만 바꿈)
+    struct gpio_v2_line_config cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = flags;
+    if (flags & GPIO_V2_LINE_FLAG_OUTPUT) { // 출력으로 바꾸는 순간의 값 - 이미 이 프로세스가 출력으로 쓰던 핀이면 지금 값 유지
+        cfg.num_attrs = 1;
+        cfg.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        cfg.attrs[0].attr.values = value ? 1 : 0;
+        cfg.attrs[0].mask = 1;
+    }
+    if (line_fd[pin] >= 0) return ioctl(line_fd[pin], GPIO_V2_LINE_SET_CONFIG_IOCTL, &cfg) == 0;
+
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+    req.offsets[0] = pin;
+    req.num_lines = 1;
+    req.config = cfg;
+    strcpy(req.consumer, "snake");
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+        perror("GPIO_V2_GET_LINE_IOCTL");
+        return 0;
+    }
+    line_fd[pin] = req.fd;
+    return 1;
+}
+
+static int line_get(uint8_t pin) { // 요청 안 된 핀은 방향을 그대로 두고(flags 0) 요청
+    if (line_fd[pin] < 0 && !line_request(pin, 0, 0)) return HAL_HIGH;
+    struct gpio_v2_line_values v = { 0, 1 };
+    if (ioctl(line_fd[pin], GPIO_V2_LINE_GET_VALUES_IOCTL, &v) < 0) return HAL_HIGH;
+    return (v.bits & 1) ? HAL_HIGH : HAL_LOW;
+}
+
+// 이 프로세스가 요청해서 쥐고 있는 출력 핀만 1 - 문자 장치는 요청 fd를 닫은 뒤 방향/값을 보장하지 않아서
+// (드라이버에 따라 입력으로 돌아가거나 값이 바뀜) 지난 실행이 남긴 RST를 믿을 수 없음 → 웜 재시작 감지 없음, 항상 하드웨어 리셋
+// 실행 사이에도 RST를 HIGH로 두려면 device tree의 gpio-hog 같은 것이 핀을 쥐고 있어야 하는데, 그러면 이 백엔드가 요청할 수 없음
+int hal_gpio_is_output(uint8_t pin) {
+    return (int)(out_pins >> pin & 1);
+}
+
+void hal_gpio_output(uint8_t pin) {
+    int level = hal_gpio_is_output(pin) ? line_get(pin) : HAL_LOW; // 이미 출력이면 지금 값을 그대로
+    if (!line_request(pin, GPIO_V2_LINE_FLAG_OUTPUT, level)) return;
+    out_pins |= 1ull << pin;
+    if (pin == TFT_DC) dc_level = level;
+}
+
+void hal_gpio_input_pullup(uint8_t pin) { // 양쪽 엣지 이벤트도 켬 - 샘플러가 버튼을 안 건드리는 동안 잠들 수 있음
+    uint64_t edges = GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    if (!line_request(pin, GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_BIAS_PULL_UP | edges, 0)) return;
+    fcntl(line_fd[pin], F_SETFL, fcntl(line_fd[pin], F_GETFL) | O_NONBLOCK); // hal_gpio_edge_ack가 막히지 않게
+    edge_pins |= 1ull << pin;
+}
+
+int hal_gpio_edge_fd(uint8_t pin) {
+    return (edge_pins >> pin) & 1 ? line_fd[pin] : -1;
+}
+
+void hal_gpio_edge_ack(uint8_t pin) {
+    struct gpio_v2_line_event ev[16];
+    if ((edge_pins >> pin) & 1) {
+        while (read(line_fd[pin], ev, sizeof(ev)) > 0) {}
+    }
+}
+
+void hal_gpio_write(uint8_t pin, int high) {
+    if (line_fd[pin] < 0) return;
+    if (pin == TFT_DC) {
+        if (dc_level == (high != 0)) return; // 같은 값이면 ioctl 생략 (writeData마다 불림)
+        dc_level = high != 0;
+        stat_dc++;
+    }
+    if (pin == TFT_DC || pin == TFT_RST) spi_send(); // 쌓인 바이트는 바뀌기 전 레벨로 나가야 함
+    struct gpio_v2_line_values v = { high ? 1u : 0u, 1 };
+    ioctl(line_fd[pin], GPIO_V2_LINE_SET_VALUES_IOCTL, &v);
+}
+
+int hal_gpio_read(uint8_t pin) {
+    return line_get(pin);
+}
+
+static uint32_t read_bufsiz(void) { // spidev가 메시지 하나에 받는 최대 바이트 (모듈 파라미터)
+    FILE* f = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+    unsigned v = 0;
+    if (!f) return spi_bufsiz;
+    if (fscanf(f, "%u", &v) != 1) v = 0;
+    fclose(f);
+    if (v == 0) return spi_bufsiz;
+    return v < SPIDEV_BUF_MAX ? v : SPIDEV_BUF_MAX;
+}
+
+void hal_spi_begin(void) {
+    const char* s = getenv("SNAKE_SPIDEV");
+    uint8_t mode = SPI_MODE_0, bits = 8;
+    uint32_t hz = SPIDEV_HZ;
+    spi_fd = open(s ? s : "/dev/spidev0.0", O_RDWR | O_CLOEXEC);
+    if (spi_fd < 0) {
+        perror("spidev");
+        return;
+    }
+    ioctl(spi_fd, SPI_IOC_WR_MODE, &mode);
+    ioctl(spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
+    ioctl(spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &hz);
+    spi_bufsiz = read_bufsiz();
+}
+
+void hal_spi_end(void) {
+    spi_send();
+    if (spi_fd >= 0) close(spi_fd);
+    spi_fd = -1;
+}
+
+void hal_spi_write(const uint8_t* buf, uint32_t len) {
+    while (len > 0) {
+        if (msg_len == spi_bufsiz) spi_send(); // 커널이 받는 크기를 넘으면 나눠 보냄
+        uint32_t k = spi_bufsiz - msg_len;
+        if (k > len) k = len;
+        memcpy(&msg_buf[msg_len], buf, k); // 호출한 쪽 버퍼는 바로 다시 쓰이므로 복사
+        msg_len += k;
+        buf += k;
+        len -= k;
+    }
+}
+
+void hal_spi_flush(void) {
+    spi_send();
+}
+
+void hal_delay_ms(uint32_t ms) {
+    struct timespec ts = { (time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L };
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {}
+}
+
+uint64_t hal_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+void hal_sleep_until_us(uint64_t t_us) {
+    struct timespec ts = { (time_t)(t_us / 1000000u), (long)(t_us % 1000000u) * 1000L };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {} // 시그널로 깨면 다시 잠
+}
+
+int hal_quit_requested(void) { return 0; }
+
+const uint16_t* hal_host_panel(void) { return NULL; }
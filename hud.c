@@ -0,0 +1,43 @@
+#include "hud.h"
+
+#include "config.h"
+#include "tiles.h"
+
+#define HUD_CELLS (GRID_W * HUD_ROWS)
+
+// HUD 위젯: [x, x + w) 칸을 차지하고, 칸마다 타일을 정함
+// 위젯을 추가할 때는 필요한 값을 HudState에 넣고 아래 layout 표에 자리만 나눠 주면 됨 (그리는 비용은 바뀐 칸만큼)
+typedef struct {
+    uint8_t x, y, w; // w가 0이면 줄 끝까지
+    TileId (*tile)(const HudState* s, int i, int w); // i번째 칸 타일
+} HudWidget;
+
+static TileId score_bar(const HudState* s, int i, int w) { // 파란 칸: 점수, 빨간 칸: 대전 상대 점수, 빈 칸: 빈 공간
+    if (i < s->score) return TILE_HUD;
+    return i >= w - s->rival ? TILE_HUD2 : TILE_EMPTY;
+}
+
+static const HudWidget layout[] = {
+    { 0, 0, 0, score_bar }, // 격자 너비 = CLEAR_SCORE
+};
+
+static uint8_t shown[GRID_MAX * HUD_ROWS]; // 패널에 그려져 있는 HUD 칸 타일 (앞쪽 HUD_CELLS개)
+
+void hud_reset(void) {
+    for (int i = 0; i < HUD_CELLS; i++) shown[i] = TILE_EMPTY;
+}
+
+void hud_update(const HudState* s) {
+    for (unsigned k = 0; k < sizeof(layout) / sizeof(layout[0]); k++) {
+        const HudWidget* wd = &layout[k];
+        int w = wd->w ? wd->w : GRID_W - wd->x;
+        for (int i = 0; i < w; i++) {
+            int x = wd->x + i;
+            TileId t = wd->tile(s, i, w);
+            uint8_t* old = &shown[wd->y * GRID_W + x];
+            if (*old == t) continue; // 안 바뀐 칸은 건너뜀
+            *old = (uint8_t)t;
+            draw_tile((uint16_t)x, wd->y, t);
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+// 점수 바 등 화면 위쪽 HUD_ROWS 줄을 관리
+// 마지막으로 그린 칸 타일을 기억해 두고, 바뀐 칸만 다시 그림
+// HUD 칸은 이 모듈만 그리고, 뱀/음식은 HUD 줄에 그려지지 않음(game.c의 apply_events, draw_versus가 HUD_ROWS 아래 칸만 그림)
+
+typedef struct {
+    int score; // 현재 점수
+    int rival; // 대전 모드 상대 점수 - 점수 바 오른쪽 끝부터 빨간 칸 (혼자면 0)
+} HudState;
+
+void hud_reset(void); // 화면 전체를 검은색으로 지운 직후 호출 - 캐시를 빈 칸(TILE_EMPTY)으로 맞춤
+void hud_update(const HudState* s); // 바뀐 칸만 그림
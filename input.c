@@ -0,0 +1,201 @@
+#include "input.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "hal.h"
+
+typedef enum { DB_UP, DB_PRESSING, DB_DOWN, DB_RELEASING } DebounceState; // 핀별 디바운스 상태
+
+typedef struct {
+    DebounceState st;
+    uint64_t since_us; // 바뀌기 시작한 시각
+} Debounce;
+
+static const uint8_t key_pins[KEY_COUNT] = { PIN_UP, PIN_DOWN, PIN_LEFT, PIN_RIGHT, PIN_CENTER, PIN_A, PIN_B };
+static Debounce db[KEY_COUNT];
+
+// 단일 생산자(샘플러) / 단일 소비자(게임 루프) 링 버퍼
+static InputEvent queue[INPUT_QUEUE_SIZE];
+static atomic_uint q_head; // 생산자만 씀
+static atomic_uint q_tail; // 소비자만 씀
+static atomic_uint q_overflow; // 꽉 차서 버린 이벤트 수
+
+static pthread_t sampler;
+static atomic_int running;
+static int threaded = 0;
+static int notify_fd = -1; // 이벤트를 넣을 때마다 올림 (input_fd)
+static int edge_ep = -1;   // 버튼 핀 엣지 fd + stop_fd를 모은 epoll - 백엔드가 엣지를 못 주면 -1 (주기 샘플링만)
+static int stop_fd = -1;   // input_stop이 잠든 샘플러를 깨움
+static int edge_driven = 0; // 엣지 대기 중 (보고용 - input_stop 뒤에도 남음, 대기가 실패하면 0)
+static uint64_t wakeups = 0, edge_waits = 0; // 샘플러가 깬 횟수, 그중 엣지를 기다리다 깬 횟수
+
+// 지연 통계 (게임 루프에서만 갱신)
+static uint32_t lat_n = 0;
+static uint64_t lat_sum_us = 0, lat_max_us = 0, lat_last_us = 0;
+
+static void push(uint8_t key, uint8_t pressed, uint64_t t_us) {
+    unsigned h = atomic_load_explicit(&q_head, memory_order_relaxed);
+    unsigned t = atomic_load_explicit(&q_tail, memory_order_acquire);
+    if (h - t >= INPUT_QUEUE_SIZE) { // 꽉 참
+        atomic_fetch_add_explicit(&q_overflow, 1, memory_order_relaxed);
+        return;
+    }
+    queue[h & (INPUT_QUEUE_SIZE - 1)] = (InputEvent){ t_us, key, pressed };
+    atomic_store_explicit(&q_head, h + 1, memory_order_release);
+    if (notify_fd >= 0) eventfd_write(notify_fd, 1);
+}
+
+static void sample_once(uint64_t now) { // 모든 핀을 한 번 읽고 상태 기계 진행
+    for (int k = 0; k < KEY_COUNT; k++) {
+        int low = hal_gpio_read(key_pins[k]) == HAL_LOW; // 풀업이라 LOW가 눌림
+        Debounce* d = &db[k];
+        switch (d->st) {
+        case DB_UP:
+            if (low) { d->st = DB_PRESSING; d->since_us = now; }
+            break;
+        case DB_PRESSING:
+            if (!low) d->st = DB_UP; // 튐(bounce) - 무시
+            else if (now - d->since_us >= INPUT_DEBOUNCE_US) { d->st = DB_DOWN; push((uint8_t)k, 1, d->since_us); }
+            break;
+        case DB_DOWN:
+            if (!low) { d->st = DB_RELEASING; d->since_us = now; }
+            break;
+        case DB_RELEASING:
+            if (low) d->st = DB_DOWN;
+            else if (now - d->since_us >= INPUT_DEBOUNCE_US) { d->st = DB_UP; push((uint8_t)k, 0, d->since_us); }
+            break;
+        }
+    }
+}
+
+static int settled(void) { // 디바운스 중인 버튼이 없음
+    for (int k = 0; k < KEY_COUNT; k++) {
+        if (db[k].st == DB_PRESSING || db[k].st == DB_RELEASING) return 0;
+    }
+    return 1;
+}
+
+static int idle_now(void) { // 쌓인 엣지를 버린 뒤 한 번 더 읽어 봄 - 그 사이 바뀐 게 없으면 다음 엣지까지 자도 됨
+    if (edge_ep < 0 || !settled()) return 0;
+    for (int k = 0; k < KEY_COUNT; k++) hal_gpio_edge_ack(key_pins[k]);
+    sample_once(hal_now_us());
+    return settled();
+}
+
+static void* sampler_main(void* arg) { // 샘플링 스레드 - 디바운스 중에는 고정 주기, 안정되면 엣지까지 잠
+    (void)arg;
+    uint64_t next = hal_now_us();
+    while (atomic_load_explicit(&running, memory_order_relaxed)) {
+        sample_once(hal_now_us());
+        if (idle_now()) {
+            struct epoll_event ev;
+            int n;
+            while ((n = epoll_wait(edge_ep, &ev, 1, -1)) < 0 && errno == EINTR) {} // 시그널로 깨면 다시 잠
+            if (n < 0) { // 다른 오류는 다시 불러도 같음 - 엣지 대기를 접고 주기 샘플링으로
+                perror("input: edge wait");
+                close(edge_ep);
+                edge_ep = -1; // input_stop은 join한 뒤에야 읽음
+                edge_driven = 0;
+                next = hal_now_us();
+                continue;
+            }
+            edge_waits++;
+            wakeups++;
+            next = hal_now_us(); // 엣지 뒤부터 다시 주기 샘플링
+            continue;
+        }
+        next += INPUT_SAMPLE_US;
+        hal_sleep_until_us(next);
+        wakeups++;
+    }
+    return NULL;
+}
+
+static void edges_open(void) { // 모든 버튼 핀이 엣지 fd를 줄 때만 사용 - 하나라도 없으면 주기 샘플링
+    struct epoll_event ev = { .events = EPOLLIN };
+    for (int k = 0; k < KEY_COUNT; k++) {
+        if (hal_gpio_edge_fd(key_pins[k]) < 0) return;
+    }
+    edge_ep = epoll_create1(EPOLL_CLOEXEC);
+    stop_fd = eventfd(0, EFD_CLOEXEC);
+    if (edge_ep < 0 || stop_fd < 0 || epoll_ctl(edge_ep, EPOLL_CTL_ADD, stop_fd, &ev) < 0) goto fail;
+    for (int k = 0; k < KEY_COUNT; k++) {
+        if (epoll_ctl(edge_ep, EPOLL_CTL_ADD, hal_gpio_edge_fd(key_pins[k]), &ev) < 0) goto fail;
+    }
+    edge_driven = 1;
+    return;
+fail:
+    perror("input: edge epoll");
+    if (edge_ep >= 0) close(edge_ep);
+    if (stop_fd >= 0) close(stop_fd);
+    edge_ep = stop_fd = -1;
+}
+
+int input_start(void) {
+    for (int k = 0; k < KEY_COUNT; k++) {
+        hal_gpio_input_pullup(key_pins[k]); // 입력 + 풀업(기본값 HIGH)
+        db[k].st = DB_UP;
+    }
+    if (!hal_realtime()) return 1; // 가상 시계에서는 input_pump로 샘플링
+
+    notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    edges_open();
+    atomic_store(&running, 1);
+    if (pthread_create(&sampler, NULL, sampler_main, NULL) != 0) return 0;
+    threaded = 1;
+    return 1;
+}
+
+void input_stop(void) {
+    if (!threaded) return;
+    atomic_store(&running, 0);
+    if (stop_fd >= 0) eventfd_write(stop_fd, 1); // 엣지를 기다리며 자고 있으면 깨움
+    pthread_join(sampler, NULL);
+    threaded = 0;
+    if (edge_ep >= 0) close(edge_ep);
+    if (stop_fd >= 0) close(stop_fd);
+    edge_ep = stop_fd = -1;
+}
+
+void input_pump(void) {
+    if (!threaded) sample_once(hal_now_us());
+}
+
+int input_fd(void) {
+    return threaded ? notify_fd : -1;
+}
+
+int input_poll(InputEvent* ev) {
+    unsigned t = atomic_load_explicit(&q_tail, memory_order_relaxed);
+    unsigned h = atomic_load_explicit(&q_head, memory_order_acquire);
+    if (t == h) return 0;
+    *ev = queue[t & (INPUT_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&q_tail, t + 1, memory_order_release);
+    return 1;
+}
+
+void input_latency_record(uint64_t t_edge_us) {
+    uint64_t now = hal_now_us();
+    uint64_t lat = now > t_edge_us ? now - t_edge_us : 0;
+    lat_last_us = lat;
+    if (lat > lat_max_us) lat_max_us = lat;
+    lat_sum_us += lat;
+    lat_n++;
+}
+
+void input_report(void) {
+    printf("input: applied %u, latency last %llu us, max %llu us, mean %llu us, overflow %u\n",
+           lat_n, (unsigned long long)lat_last_us, (unsigned long long)lat_max_us,
+           (unsigned long long)(lat_n ? lat_sum_us / lat_n : 0), atomic_load(&q_overflow));
+    if (wakeups) {
+        printf("input: sampler woke %llu times (%llu from edge waits, %s)\n", (unsigned long long)wakeups,
+               (unsigned long long)edge_waits, edge_driven ? "edge-driven" : "polling every 1 ms");
+    }
+}
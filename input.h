@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// 버튼 입력 샘플러
+// 실제 하드웨어(hal_realtime)에서는 전용 스레드가 INPUT_SAMPLE_US마다 모든 핀을 읽고,
+// 핀별 상태 기계로 디바운스한 뒤 눌림/뗌 이벤트를 단일 생산자/단일 소비자 락프리 큐에 넣음.
+// 백엔드가 엣지 fd를 주면(hal_gpio_edge_fd) 모든 버튼이 안정된 동안은 주기 샘플링을 멈추고 엣지가 올 때까지 잠.
+// 이벤트를 넣을 때마다 input_fd(eventfd)를 올려서 게임 루프가 입력을 기다리며 잘 수 있게 함.
+// 가상 시계(호스트 백엔드)에서는 스레드 없이 input_pump()를 부른 쪽에서 샘플링함.
+
+#define INPUT_SAMPLE_US 1000   // 샘플링 주기 (1 kHz)
+#define INPUT_DEBOUNCE_US 5000 // 이 시간 동안 같은 값이면 상태 변화로 인정
+#define INPUT_QUEUE_SIZE 64    // 이벤트 큐 크기 (2의 거듭제곱)
+
+typedef enum { KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_CENTER, KEY_A, KEY_B, KEY_COUNT } Key;
+
+typedef struct {
+    uint64_t t_us;   // 처음 엣지를 본 시각 (hal_now_us 기준)
+    uint8_t key;     // Key
+    uint8_t pressed; // 1: 눌림, 0: 뗌
+} InputEvent;
+
+int input_start(void); // 핀 설정 후 샘플러 시작
+void input_stop(void);
+void input_pump(void); // 샘플러 스레드가 없으면 여기서 한 번 샘플링 (있으면 아무것도 안 함)
+int input_poll(InputEvent* ev); // 큐에서 이벤트 하나 꺼냄. 없으면 0
+int input_fd(void); // 큐에 이벤트가 들어오면 읽을 수 있는 eventfd (샘플러 스레드가 없으면 -1) - 읽어서 비우는 건 기다린 쪽
+
+void input_latency_record(uint64_t t_edge_us); // 엣지부터 게임에 반영될 때까지 걸린 시간 기록
+void input_report(void); // 입력 지연/큐 넘침 통계 출력
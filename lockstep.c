@@ -0,0 +1,424 @@
+#include "lockstep.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "config.h"
+
+// 패킷 (리틀 엔디언)
+//  HELLO: [1][플레이어][시드 8바이트][격자 너비 2][격자 높이 2] - 격자가 다르면 대전 안 함
+//  INPUT: [2][n][첫 틱 4][방향 n바이트][ack 4][체크섬 틱 4][체크섬 4][보낸 시각 4][echo 4][hold 4]
+//         ack: 상대 입력을 이 틱 전까지 다 받았음, echo/hold: 상대가 마지막으로 보낸 시각과 그걸 들고 있던 시간 (왕복 시간)
+//  BYE:   [3][마지막 틱 4]
+enum { PKT_HELLO = 1, PKT_INPUT = 2, PKT_BYE = 3 };
+
+#define PKT_MAX (2 + 4 + LOCKSTEP_RING + 4 * 6)
+#define WINDOW (LOCKSTEP_ROLLBACK + 1) // 보관할 틱 수 - 확정 안 된 틱 전부 + 확정된 마지막 틱
+#define HELLO_MS 100   // 인사 재전송 간격
+#define KEEPALIVE_MS 20 // 보낼 게 없어도 이 간격으로는 보냄 (ack/왕복 시간)
+
+typedef union {
+    struct sockaddr sa;
+    struct sockaddr_in in;
+    struct sockaddr_un un;
+} Addr;
+
+static int sock = -1;
+static Addr peer_addr;
+static socklen_t peer_len;
+static char bind_path[sizeof(((struct sockaddr_un*)0)->sun_path)]; // 유닉스 소켓이면 닫을 때 지움
+static int me = 0;     // 플레이어 번호
+static int delay = LOCKSTEP_DELAY;
+static int started = 0; // 인사가 끝났음
+static uint64_t hello_seed = 0; // 인사에 실어 보내는 시드 (1번은 0)
+
+static Arena mem;              // cur의 격자 크기 배열 - lockstep_open에서 한 번
+static VsState cur;            // 틱 now의 상태 (예측 포함)
+static VsUndo undo[WINDOW];    // undo[t % WINDOW] = t번째 vs_step을 되돌리는 기록 - 되감기는 이걸 최근 것부터 적용
+static uint32_t after_ck[WINDOW];     // [t % WINDOW] = 틱 t까지 진행한 상태의 체크섬 (예측 포함, 다시 진행하면 새로 씀)
+static VsStatus after_status[WINDOW]; // 그때의 결과
+static int grid_mismatch = 0;  // 상대 HELLO의 격자 크기가 다름
+static uint32_t now_tick = 0;  // 진행한 틱 수
+static uint8_t local_in[LOCKSTEP_RING];  // [t % RING] = 틱 t에 적용할 내 입력
+static uint32_t local_n = 0;   // 내 입력이 정해진 틱 수 (now_tick + delay)
+static uint8_t remote_in[LOCKSTEP_RING];
+static uint32_t remote_n = 0;  // 상대 입력을 처음부터 빠짐없이 받은 틱 수
+static uint32_t peer_ack = 0;  // 상대가 받았다고 알려 온 내 입력 틱 수
+static uint32_t rollback_from = UINT32_MAX; // 예측이 틀린 가장 이른 틱
+static Dir pending[TURN_QUEUE]; // 아직 틱에 안 실은 로컬 입력 - 틱마다 하나씩
+static int pending_n = 0;
+
+static uint32_t confirmed = 0; // 양쪽 입력이 확정된 틱 수 = min(now_tick, remote_n)
+static uint32_t ck[LOCKSTEP_RING]; // [t % RING] = 확정된 t 틱 진행한 상태의 체크섬
+static VsStatus result = VS_RUNNING;
+static uint32_t peer_ck_tick = 0, peer_ck = 0; // 상대가 보낸 체크섬 중 아직 비교 못 한 것
+static int peer_ck_valid = 0;
+
+static uint32_t peer_t = 0;      // 상대가 마지막 패킷을 보낸 시각 (상대 시계)
+static uint64_t peer_t_rx = 0;   // 그 패킷을 받은 시각 (내 시계)
+static uint64_t last_rx_us = 0, last_tx_us = 0;
+static int peer_bye = 0;
+static int dirty = 1; // 지난번 보낸 뒤로 보낼 내용이 바뀜
+
+static struct {
+    uint32_t sent, received, bad;
+    uint32_t rtt_n;
+    uint64_t rtt_sum_us, rtt_min_us, rtt_max_us;
+    uint32_t stalls;          // 상대 입력을 기다리느라 틱을 못 한 횟수 (연속은 한 번)
+    uint64_t stall_sum_us, stall_max_us;
+    uint32_t rollbacks, resim_ticks, rollback_max;
+    uint32_t checks, desyncs, first_desync;
+} st;
+static uint64_t stall_t0 = 0; // 지금 stall 중이면 시작 시각
+
+static uint64_t mono_us(void) { // 왕복 시간/시간 초과는 실제 시간으로 (호스트 백엔드의 가상 시계 아님)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static int parse_addr(const char* s, Addr* a, socklen_t* len) { // "udp:호스트:포트" 또는 "unix:경로"
+    memset(a, 0, sizeof(*a));
+    if (strncmp(s, "unix:", 5) == 0) {
+        if (strlen(s + 5) >= sizeof(a->un.sun_path)) return 0;
+        a->un.sun_family = AF_UNIX;
+        strcpy(a->un.sun_path, s + 5);
+        *len = sizeof(a->un);
+        return 1;
+    }
+    if (strncmp(s, "udp:", 4) == 0) {
+        char host[64];
+        const char* colon = strrchr(s + 4, ':');
+        if (!colon || colon - (s + 4) >= (long)sizeof(host)) return 0;
+        memcpy(host, s + 4, (size_t)(colon - (s + 4)));
+        host[colon - (s + 4)] = 0;
+        a->in.sin_family = AF_INET;
+        a->in.sin_port = htons((uint16_t)atoi(colon + 1));
+        if (inet_pton(AF_INET, host, &a->in.sin_addr) != 1) return 0;
+        *len = sizeof(a->in);
+        return 1;
+    }
+    return 0;
+}
+
+int lockstep_open(int player, const char* bind_s, const char* peer_s, int d) {
+    char def_bind[32], def_peer[32];
+    Addr local;
+    socklen_t local_len;
+    me = player ? 1 : 0;
+    delay = d < 0 ? 0 : d > LOCKSTEP_RING / 4 ? LOCKSTEP_RING / 4 : d;
+    snprintf(def_bind, sizeof(def_bind), "udp:127.0.0.1:%d", LOCKSTEP_PORT + me);
+    snprintf(def_peer, sizeof(def_peer), "udp:127.0.0.1:%d", LOCKSTEP_PORT + 1 - me);
+    if (!parse_addr(bind_s ? bind_s : def_bind, &local, &local_len) ||
+        !parse_addr(peer_s ? peer_s : def_peer, &peer_addr, &peer_len) ||
+        local.sa.sa_family != peer_addr.sa.sa_family) {
+        printf("lockstep: bad address (use udp:host:port or unix:path)\n");
+        return 0;
+    }
+    sock = socket(local.sa.sa_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        perror("lockstep socket");
+        return 0;
+    }
+    if (local.sa.sa_family == AF_UNIX) {
+        unlink(local.un.sun_path); // 지난 실행이 남긴 소켓 파일
+        strcpy(bind_path, local.un.sun_path);
+    }
+    if (bind(sock, &local.sa, local_len) != 0) {
+        perror("lockstep bind");
+        return 0;
+    }
+    return arena_init(&mem, vs_state_bytes()) && vs_alloc(&cur, &mem);
+}
+
+static void send_pkt(const uint8_t* p, int len) {
+    if (sendto(sock, p, (size_t)len, 0, &peer_addr.sa, peer_len) == len) st.sent++; // 상대가 아직 없으면 실패 - 재전송함
+    last_tx_us = mono_us();
+}
+
+static void send_hello(uint64_t seed) {
+    uint8_t p[14] = { PKT_HELLO, (uint8_t)me };
+    for (int i = 0; i < 8; i++) p[2 + i] = (uint8_t)(seed >> (i * 8));
+    p[10] = (uint8_t)GRID_W;
+    p[11] = (uint8_t)(GRID_W >> 8);
+    p[12] = (uint8_t)GRID_H;
+    p[13] = (uint8_t)(GRID_H >> 8);
+    send_pkt(p, sizeof(p));
+}
+
+static void send_input(void) { // 상대가 아직 못 받은 내 입력 전부 + ack + 체크섬 + 시각
+    uint8_t p[PKT_MAX];
+    uint32_t first = peer_ack, n = local_n - peer_ack;
+    if (n > LOCKSTEP_RING) n = LOCKSTEP_RING;
+    uint64_t now = mono_us();
+    int k = 0;
+    p[k++] = PKT_INPUT;
+    p[k++] = (uint8_t)n;
+    put32(&p[k], first); k += 4;
+    for (uint32_t i = 0; i < n; i++) p[k++] = local_in[(first + i) % LOCKSTEP_RING];
+    put32(&p[k], remote_n); k += 4;
+    put32(&p[k], confirmed ? confirmed : UINT32_MAX); k += 4; // 가장 최근에 확정된 상태
+    put32(&p[k], ck[confirmed % LOCKSTEP_RING]); k += 4;
+    put32(&p[k], (uint32_t)now); k += 4;
+    put32(&p[k], peer_t); k += 4;
+    put32(&p[k], peer_t ? (uint32_t)(now - peer_t_rx) : 0); k += 4;
+    send_pkt(p, k);
+    dirty = 0;
+}
+
+static void check_peer_ck(void) { // 상대 체크섬을 내 것과 비교 - 내 쪽도 그 틱이 확정돼야 가능
+    if (!peer_ck_valid || peer_ck_tick > confirmed) return;
+    peer_ck_valid = 0;
+    if (confirmed - peer_ck_tick >= LOCKSTEP_RING) return; // 너무 오래된 것
+    st.checks++;
+    if (ck[peer_ck_tick % LOCKSTEP_RING] != peer_ck) {
+        if (!st.desyncs) {
+            st.first_desync = peer_ck_tick;
+            printf("lockstep: DESYNC at tick %u (mine %08x, peer %08x)\n", peer_ck_tick,
+                   ck[peer_ck_tick % LOCKSTEP_RING], peer_ck);
+        }
+        st.desyncs++;
+    }
+}
+
+static void confirm(void) { // 확정된 틱을 앞으로 - 체크섬을 남기고 결과 확인
+    uint32_t target = remote_n < now_tick ? remote_n : now_tick;
+    while (confirmed < target) {
+        confirmed++;
+        ck[confirmed % LOCKSTEP_RING] = after_ck[confirmed % WINDOW]; // confirmed 틱까지 진행한 상태
+        if (result == VS_RUNNING) result = after_status[confirmed % WINDOW];
+        dirty = 1;
+    }
+    check_peer_ck();
+}
+
+static Dir input_at(const uint8_t* ring, uint32_t n, uint32_t t) { // 아직 모르면 "안 바꿈"으로 예측
+    return t < n ? (Dir)ring[t % LOCKSTEP_RING] : DIR_NONE;
+}
+
+static void step_once(void) { // 되돌리기 기록을 남기며 한 틱 진행
+    Dir in[VS_PLAYERS];
+    in[me] = input_at(local_in, local_n, now_tick);
+    in[1 - me] = input_at(remote_in, remote_n, now_tick);
+    vs_step(&cur, in, &undo[now_tick % WINDOW]);
+    now_tick++;
+    after_ck[now_tick % WINDOW] = vs_checksum(&cur);
+    after_status[now_tick % WINDOW] = cur.status;
+}
+
+static void rollback(void) { // 예측이 틀린 틱으로 되돌아가 지금까지 다시 진행
+    if (rollback_from >= now_tick) {
+        rollback_from = UINT32_MAX;
+        return;
+    }
+    uint32_t target = now_tick, depth = now_tick - rollback_from;
+    while (now_tick > rollback_from) vs_undo(&cur, &undo[--now_tick % WINDOW]); // 틱마다 O(1)
+    while (now_tick < target) step_once();
+    st.rollbacks++;
+    st.resim_ticks += depth;
+    if (depth > st.rollback_max) st.rollback_max = depth;
+    rollback_from = UINT32_MAX;
+}
+
+static void on_input(const uint8_t* p, int len) {
+    if (len < 6) { st.bad++; return; }
+    uint32_t n = p[1], first = get32(&p[2]);
+    if (len < (int)(6 + n + 24)) { st.bad++; return; }
+    for (uint32_t i = 0; i < n; i++) { // 이어지는 것만 받음 - 앞이 빠졌으면 재전송을 기다림
+        uint32_t t = first + i;
+        if (t != remote_n) continue;
+        Dir d = (Dir)p[6 + i];
+        if (d > DIR_NONE) { st.bad++; return; }
+        remote_in[t % LOCKSTEP_RING] = (uint8_t)d;
+        remote_n++;
+        dirty = 1;
+        if (t < now_tick && d != DIR_NONE && t < rollback_from) rollback_from = t; // 이미 "안 바꿈"으로 예측해서 지나간 틱
+    }
+    const uint8_t* q = &p[6 + n];
+    uint32_t ack = get32(q);
+    if (ack > peer_ack && ack <= local_n) peer_ack = ack;
+    uint32_t ct = get32(q + 4);
+    if (ct != UINT32_MAX) {
+        peer_ck_tick = ct;
+        peer_ck = get32(q + 8);
+        peer_ck_valid = 1;
+    }
+    uint64_t now = mono_us();
+    peer_t = get32(q + 12);
+    peer_t_rx = now;
+    uint32_t echo = get32(q + 16), hold = get32(q + 20);
+    if (echo) { // 내가 보낸 시각이 돌아옴 - 상대가 들고 있던 시간은 뺌
+        uint64_t rtt = (uint32_t)((uint32_t)now - echo - hold);
+        if (rtt < 10000000u) {
+            st.rtt_n++;
+            st.rtt_sum_us += rtt;
+            if (!st.rtt_min_us || rtt < st.rtt_min_us) st.rtt_min_us = rtt;
+            if (rtt > st.rtt_max_us) st.rtt_max_us = rtt;
+        }
+    }
+}
+
+static int recv_all(uint64_t* seed) { // 쌓인 패킷 모두 처리. 인사(HELLO)를 받았으면 1
+    uint8_t p[PKT_MAX];
+    int hello = 0;
+    while (1) {
+        ssize_t len = recv(sock, p, sizeof(p), 0);
+        if (len < 0) break; // EAGAIN - 더 없음 (상대 소켓이 아직 없을 때의 ECONNREFUSED 포함)
+        if (len < 1) continue;
+        st.received++;
+        last_rx_us = mono_us();
+        if (p[0] == PKT_HELLO && len >= 14 && p[1] == 1 - me) {
+            if ((p[10] | p[11] << 8) != GRID_W || (p[12] | p[13] << 8) != GRID_H) {
+                if (!grid_mismatch) printf("lockstep: peer grid is %dx%d, mine %dx%d\n", p[10] | p[11] << 8,
+                                           p[12] | p[13] << 8, GRID_W, GRID_H);
+                grid_mismatch = 1;
+                continue;
+            }
+            if (seed && me == 1) {
+                *seed = 0;
+                for (int i = 0; i < 8; i++) *seed |= (uint64_t)p[2 + i] << (i * 8);
+            }
+            hello = 1;
+        } else if (p[0] == PKT_INPUT && started) {
+            on_input(p, (int)len);
+        } else if (p[0] == PKT_BYE) {
+            peer_bye = 1;
+        } else if (p[0] != PKT_INPUT) {
+            st.bad++;
+        }
+    }
+    return hello;
+}
+
+int lockstep_handshake(uint64_t* seed) {
+    uint64_t t0 = mono_us(), last = 0;
+    hello_seed = me == 0 ? *seed : 0;
+    printf("lockstep: player %d waiting for peer...\n", me);
+    while (1) {
+        uint64_t now = mono_us();
+        if (now - last >= HELLO_MS * 1000u) {
+            send_hello(hello_seed);
+            last = now;
+        }
+        if (recv_all(seed)) break;
+        if (grid_mismatch) return 0;
+        if (now - t0 > (uint64_t)LOCKSTEP_TIMEOUT_MS * 1000u * 6) return 0; // 상대 프로세스를 띄울 시간은 넉넉히
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+    }
+    send_hello(hello_seed); // 상대가 아직 내 인사를 못 받았을 수도 있음 - 이후에는 INPUT이 그 역할
+    started = 1;
+    vs_init(&cur, *seed);
+    for (uint32_t t = 0; t < (uint32_t)delay; t++) local_in[t % LOCKSTEP_RING] = DIR_NONE; // 처음 지연 구간은 입력 없음
+    local_n = (uint32_t)delay;
+    last_rx_us = mono_us();
+    return 1;
+}
+
+void lockstep_local_input(Dir d) {
+    if (pending_n < TURN_QUEUE) pending[pending_n++] = d;
+}
+
+void lockstep_poll(void) {
+    if (recv_all(NULL) && started) send_hello(hello_seed); // 상대가 아직 내 인사를 못 받았음 - 다시 답해 줌
+    rollback();
+    confirm();
+    uint64_t now = mono_us();
+    if (dirty || now - last_tx_us >= KEEPALIVE_MS * 1000u) send_input();
+}
+
+int lockstep_advance(void) {
+    int ok = cur.status == VS_RUNNING // 예측 상태에서 끝났으면 확정될 때까지 기다림 (되감기로 살아날 수 있음)
+             && now_tick < remote_n + LOCKSTEP_ROLLBACK // 예측은 이만큼까지만
+             && now_tick + (uint32_t)delay < peer_ack + LOCKSTEP_RING; // 재전송할 입력이 링을 넘지 않게
+    if (!ok) {
+        if (cur.status == VS_RUNNING && !stall_t0) {
+            stall_t0 = mono_us();
+            st.stalls++;
+        }
+        return 0;
+    }
+    if (stall_t0) {
+        uint64_t us = mono_us() - stall_t0;
+        st.stall_sum_us += us;
+        if (us > st.stall_max_us) st.stall_max_us = us;
+        stall_t0 = 0;
+    }
+    Dir d = DIR_NONE; // 이번 틱에 실을 로컬 입력 - delay 틱 뒤에 적용
+    if (pending_n > 0) {
+        d = pending[0];
+        for (int i = 1; i < pending_n; i++) pending[i - 1] = pending[i];
+        pending_n--;
+    }
+    local_in[local_n % LOCKSTEP_RING] = (uint8_t)d;
+    local_n++;
+    step_once();
+    confirm();
+    dirty = 1;
+    return 1;
+}
+
+void lockstep_wait(uint32_t ms) {
+    struct pollfd p = { sock, POLLIN, 0 };
+    poll(&p, 1, (int)ms);
+}
+
+const VsState* lockstep_state(void) {
+    return &cur;
+}
+
+VsStatus lockstep_result(void) {
+    return result;
+}
+
+int lockstep_peer_gone(void) {
+    return peer_bye || mono_us() - last_rx_us > (uint64_t)LOCKSTEP_TIMEOUT_MS * 1000u;
+}
+
+void lockstep_close(void) {
+    if (sock < 0) return;
+    uint64_t t0 = mono_us();
+    // 끝난 틱까지 상대가 내 입력을 다 받을 때까지 조금 더 보냄 (상대도 같은 결과를 확정하도록)
+    while (started && !peer_bye && peer_ack < local_n && mono_us() - t0 < 500000u) {
+        lockstep_poll();
+        struct timespec ts = { 0, 5000000L };
+        nanosleep(&ts, NULL);
+    }
+    uint8_t p[5] = { PKT_BYE };
+    put32(&p[1], now_tick);
+    for (int i = 0; i < 3; i++) send_pkt(p, sizeof(p));
+    close(sock);
+    sock = -1;
+    if (bind_path[0]) unlink(bind_path);
+}
+
+void lockstep_report(void) {
+    printf("lockstep: player %d, delay %d, rollback window %d, ticks %u (confirmed %u), checksum %08x\n", me, delay,
+           LOCKSTEP_ROLLBACK, now_tick, confirmed, ck[confirmed % LOCKSTEP_RING]);
+    printf("lockstep: rtt min %.2f ms, mean %.2f ms, max %.2f ms (%u samples), packets sent %u, received %u, bad %u\n",
+           st.rtt_min_us / 1e3, st.rtt_n ? st.rtt_sum_us / 1e3 / st.rtt_n : 0.0, st.rtt_max_us / 1e3, st.rtt_n,
+           st.sent, st.received, st.bad);
+    printf("lockstep: stalls %u (total %.1f ms, max %.1f ms), rollbacks %u (%u ticks resimulated, max depth %u)\n",
+           st.stalls, st.stall_sum_us / 1e3, st.stall_max_us / 1e3, st.rollbacks, st.resim_ticks, st.rollback_max);
+    if (st.desyncs) printf("lockstep: %u of %u checksums MISMATCH, first at tick %u\n", st.desyncs, st.checks, st.first_desync);
+    else printf("lockstep: %u checksums ok\n", st.checks);
+}
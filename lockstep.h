@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "versus.h"
+
+// 두 기기(또는 한 기기의 두 프로세스) 대전용 lockstep 동기화
+// 양쪽이 같은 시드로 같은 versus.c 시뮬레이션을 돌리고, 틱마다 방향 입력만 주고받음 (UDP 또는 유닉스 도메인 데이터그램)
+//  - 고정 입력 지연: 지금 누른 방향은 LOCKSTEP_DELAY 틱 뒤에 적용 - 그 사이 상대에게 도착
+//  - 예측/되감기: 상대 입력이 아직 없으면 "방향 안 바꿈"으로 예측하고 최대 LOCKSTEP_ROLLBACK 틱 앞서 감.
+//    나중에 온 입력이 예측과 다르면 그 틱의 상태로 되돌려 다시 시뮬레이션
+//  - 양쪽 입력이 모두 확정된 틱의 vs_checksum을 보내서 어긋남(desync) 확인
+// 패킷은 아직 확인(ack) 안 된 입력을 모두 다시 실어 보내므로 몇 개 잃어버려도 됨
+
+#define LOCKSTEP_DELAY 1      // 기본 입력 지연 (틱) - SNAKE_VS_DELAY로 바꿈
+#define LOCKSTEP_ROLLBACK 4   // 상대 입력 없이 예측으로 앞서 갈 수 있는 최대 틱
+#define LOCKSTEP_RING 64      // 입력/체크섬 보관 틱 수 (지연 + 재전송 여유)
+#define LOCKSTEP_TIMEOUT_MS 5000 // 상대가 이만큼 조용하면 연결 끊김으로 봄
+#define LOCKSTEP_PORT 7000    // 기본 주소: udp:127.0.0.1:(7000 + 플레이어 번호)
+
+// player: 0 또는 1 (0번이 시드를 정함), bind/peer: "udp:호스트:포트" 또는 "unix:경로" (NULL이면 기본 주소)
+int lockstep_open(int player, const char* bind, const char* peer, int delay);
+int lockstep_handshake(uint64_t* seed); // 상대와 인사하고 시드 맞추기 (1번은 0번 시드를 받음). 시간 초과면 0
+void lockstep_local_input(Dir d);       // 로컬 방향 입력 - 다음 틱에 지연을 붙여 보냄
+void lockstep_poll(void);               // 받은 패킷 처리 (필요하면 되감기) 후 보낼 것 전송
+int lockstep_advance(void);             // 한 틱 진행. 상대 입력을 기다려야 하면(stall) 0
+void lockstep_wait(uint32_t ms);        // 패킷이 오거나 ms가 지날 때까지 실제 시간으로 대기 (stall 중)
+const VsState* lockstep_state(void);    // 지금 상태 - 예측이 섞였을 수 있음 (그리기용)
+VsStatus lockstep_result(void);         // 양쪽 입력이 확정된 상태의 결과 - VS_RUNNING이 아니면 대전 끝
+int lockstep_peer_gone(void);           // 상대가 나갔거나(BYE) 응답이 없음
+void lockstep_close(void);              // 상대에게 종료 알림
+void lockstep_report(void);             // 왕복 시간/stall/되감기/체크섬 통계 출력
@@ -1,39 +1,171 @@
+#include <pthread.h>
 #include <stdio.h>
-#include <bcm2835.h>
+#include <stdlib.h>
+#include <time.h>
 
 #include "config.h"
+#include "framecap.h"
 #include "game.h"
+#include "hal.h"
+#include "metrics.h"
+#include "palette.h"
 #include "render.h"
 #include "st7789.h"
 
+static double wall_sec(void) { // 실제 경과 시간 측정용
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void print_host_report(double wall) { // 호스트 백엔드 벤치마크 결과
+    const St7789Stats* s = st7789_stats();
+    uint32_t frames = render_frames();
+    uint32_t ticks = game_ticks();
+    printf("virtual %.3f s, wall %.3f s\n", hal_now_us() / 1e6, wall);
+    printf("ticks %u (%.0f ticks/s), frames %u (%.0f frames/s)\n",
+           ticks, wall > 0 ? ticks / wall : 0.0, frames, wall > 0 ? frames / wall : 0.0);
+    printf("spi bytes %u (%.1f bytes/frame), windows %u (%.2f windows/frame)\n",
+           s->bytes, frames ? (double)s->bytes / frames : 0.0,
+           s->windows, frames ? (double)s->windows / frames : 0.0);
+
+    // 흉내 낸 패널을 디코딩한 결과가 프레임버퍼와 픽셀 단위로 같은지 확인
+    static uint16_t want[ST7789_RAM_W * ST7789_RAM_H];
+    render_snapshot(want);
+    const uint16_t* got = hal_host_panel();
+    int diff = 0;
+    for (int i = 0; i < ST7789_TFTWIDTH * ST7789_TFTHEIGHT; i++) diff += got[i] != want[i];
+    printf("panel check (%d-bit): %s, %d pixels differ\n", PANEL_BPP, diff ? "MISMATCH" : "ok", diff);
+}
+
+typedef struct { // 부팅 단계별 시각 (hal_now_us 기준 마이크로초)
+    int warm;             // 하드웨어 리셋을 건너뛰었으면 1
+    int parallel;         // 패널 초기화를 별도 스레드에서 했으면 1
+    uint64_t panel_us;    // st7789_init 걸린 시간
+    uint64_t render_us;   // render_init (SDL 미러)
+    uint64_t game_us;     // game_init (화면 이미지 미리 만들기, 메뉴를 프레임버퍼에)
+    uint64_t frame_us;    // 첫 프레임 전송 + DISPON
+    uint64_t ready_us;    // main 시작부터 첫 조작 가능한 화면까지
+} Startup;
+
+static Startup boot;
+
+static void* panel_init_main(void* arg) { // 패널 리셋/설정 - 메인 스레드는 그동안 SDL과 화면을 준비
+    (void)arg;
+    uint64_t t = hal_now_us();
+    st7789_init(boot.warm, PANEL_BPP); // 12비트면 픽셀 두 개를 3바이트로 전송
+    boot.panel_us = hal_now_us() - t;
+    return NULL;
+}
+
+static void print_startup(void) {
+    printf("startup (%s, %s): panel init %.1f ms, render init %.1f ms, game init %.1f ms, first frame %.1f ms, "
+           "first interactive frame at %.1f ms\n",
+           boot.warm ? "warm" : "cold", boot.parallel ? "parallel" : "sequential",
+           boot.panel_us / 1e3, boot.render_us / 1e3, boot.game_us / 1e3, boot.frame_us / 1e3, boot.ready_us / 1e3);
+}
+
+// 패널/격자 크기 - 버퍼 크기가 여기서 정해지므로 다른 초기화보다 먼저
+//  SNAKE_PANEL=WxH  : 유리 크기 (세로 기준, 기본 240x240, 240x320 모듈 등)
+//  SNAKE_ROTATE=0-3 : 90도 단위 회전 (MADCTL) - 1, 3이면 가로/세로가 바뀜
+//  SNAKE_CELL=px    : 칸 크기 (짝수 2-40, 기본 10) - 격자 = 화면 / 칸, 남는 픽셀은 검은 테두리
+static int setup_geometry(void) {
+    const char* s = getenv("SNAKE_PANEL");
+    unsigned pw = 240, ph = 240;
+    int rot = 0, cell = CELL_DEFAULT;
+    if (s && sscanf(s, "%ux%u", &pw, &ph) != 2) pw = ph = 0;
+    if ((s = getenv("SNAKE_ROTATE"))) rot = atoi(s);
+    if ((s = getenv("SNAKE_CELL"))) cell = atoi(s);
+    if (pw > ST7789_RAM_W || ph > ST7789_RAM_H || rot < 0 || rot > 3 ||
+        !st7789_setGeometry((uint16_t)pw, (uint16_t)ph, (uint8_t)rot)) {
+        printf("bad panel %ux%u rotation %d (max %dx%d, rotation 0-3)\n", pw, ph, rot, ST7789_RAM_W, ST7789_RAM_H);
+        return 0;
+    }
+    if (ST7789_TFTWIDTH & 1) { // 프레임버퍼/전송은 두 픽셀(한 바이트) 단위 - 135x240 같은 모듈은 가로로
+        printf("panel width %d is odd after rotation (framebuffer packs pixel pairs) - try SNAKE_ROTATE=1\n", ST7789_TFTWIDTH);
+        return 0;
+    }
+    if (!grid_setup(ST7789_TFTWIDTH / (cell > 0 ? cell : 1), ST7789_TFTHEIGHT / (cell > 0 ? cell : 1), cell)) {
+        printf("bad cell size %d (even, %d-%d px, at least %d cells a side)\n", cell, CELL_MIN, CELL_MAX, GRID_MIN);
+        return 0;
+    }
+    if (!render_alloc()) {
+        printf("render_alloc failed\n");
+        return 0;
+    }
+    printf("panel %dx%d (rotation %d), cell %d px, grid %dx%d = %d cells\n", ST7789_TFTWIDTH, ST7789_TFTHEIGHT, rot,
+           CELL, GRID_W, GRID_H, GRID_W * GRID_H);
+    return 1;
+}
+
 int main(void) {
-    if (!bcm2835_init()) { // bcm2835 - 라즈베리파이의 GPIO/SPI 등 제어 라이브러리 초기화
-        printf("bcm2835_init failed. Are you running as root?\n");
+    uint64_t t_start = hal_now_us();
+    if (!setup_geometry()) return 1;
+    if (!hal_init()) { // GPIO/SPI 백엔드 초기화 - bcm2835는 root 필요
+        printf("hal_init failed. Are you running as root?\n");
         return 1;
     }
 
+    // 이전 실행이 RST를 출력 HIGH로 두고 끝났으면 컨트롤러는 전원이 유지된 채 이미 깨어 있음 - 리셋 생략
+    boot.warm = hal_gpio_is_output(TFT_RST) && hal_gpio_read(TFT_RST) == HAL_HIGH;
+
     // TFT pins defined in st7789.h (TFT_DC/TFT_RST)
     // 해당  GPIO 핀을 출력으로 설정
-    bcm2835_gpio_fsel(TFT_DC,  BCM2835_GPIO_FSEL_OUTP); // 데이터/명령 선택 핀
-    bcm2835_gpio_fsel(TFT_RST, BCM2835_GPIO_FSEL_OUTP); // 리셋 핀
+    hal_gpio_output(TFT_DC);  // 데이터/명령 선택 핀
+    hal_gpio_output(TFT_RST); // 리셋 핀
+
+    // Backlight (GPIO 26) - 첫 화면이 패널에 들어간 뒤에 켬
+    hal_gpio_output(26); // 백라이트 핀을 출력으로 설정
 
-    // Backlight (GPIO 26) ON
-    bcm2835_gpio_fsel(26, BCM2835_GPIO_FSEL_OUTP); // 백라이트 핀을 출력으로 설정
-    bcm2835_gpio_set(26); // 백라이트 켜기
+    // ST7789 초기화(리셋 대기 대부분)와 SDL 미러/화면 준비를 동시에 진행
+    // 가상 시계(호스트 백엔드)는 스레드 하나만 시간을 진행시켜야 하므로 차례대로
+    pthread_t panel_thread;
+    boot.parallel = hal_realtime() && pthread_create(&panel_thread, NULL, panel_init_main, NULL) == 0;
+    if (!boot.parallel) panel_init_main(NULL);
 
-    st7789_init(); // ST7789 TFT 디스플레이 초기화. SPI 설정 및 초기화 명령 전송
+    uint64_t t = hal_now_us();
     if (!render_init()) { // SDL 미러 렌더러 초기화 - 필수 아님 임의로 추가한 기능
         printf("SDL mirror init failed\n");
     }
-    if (!game_init()) { // 게임 초기화
+    boot.render_us = hal_now_us() - t;
+    framecap_init(); // SNAKE_CAPTURE: 첫 프레임(키 프레임)부터 기록
+    t = hal_now_us();
+    int ok = game_init(); // 게임 초기화 - 메뉴 화면은 프레임버퍼에만 그려짐
+    boot.game_us = hal_now_us() - t;
+    if (boot.parallel) pthread_join(panel_thread, NULL);
+    if (!ok) {
         printf("game_init failed\n");
         return 1;
     }
 
+    pal_freeze(); // 화면/타일을 다 만들었으니 색은 다 나옴 - 여기부터 전송 스레드가 펼치기 표를 읽음
+
+    // 첫 프레임: 패널 RAM은 리셋 직후 쓰레기값이거나 이전 실행의 화면이므로 전체를 보냄
+    t = hal_now_us();
+    render_invalidate();
+    render_present();
+    render_wait(); // 메뉴가 패널 RAM에 다 들어간 뒤에
+    st7789_displayOn(); // 화면 켜기 - 켜지자마자 메뉴가 보임
+    hal_gpio_write(26, HAL_HIGH); // 백라이트 켜기
+    boot.frame_us = hal_now_us() - t;
+    boot.ready_us = hal_now_us() - t_start;
+    print_startup();
+
+    metrics_init(); // -DMETRICS 빌드에서 SNAKE_METRICS 파일 열기
+    double t0 = wall_sec();
     game_loop(); // 게임 루프 시작
+    double wall = wall_sec() - t0;
+
+    render_quit(); // 남은 프레임 전송 후 렌더러 종료
+    framecap_report(); // 캡처 중이면 남은 프레임을 쓰고 닫음
+    game_report(); // 틱 지연 통계
+    render_report(); // TFT 전송 통계
+    metrics_report(); // 단계별 시간 (-DMETRICS 빌드만)
+    if (!hal_realtime()) print_host_report(wall); // 헤드리스 실행이면 측정값 출력
+    else if (game_replaying()) printf("replay wall %.3f s (%.0f ticks/s, %.0f frames/s)\n", wall,
+                                      wall > 0 ? game_ticks() / wall : 0.0, wall > 0 ? render_frames() / wall : 0.0);
 
-    bcm2835_spi_end(); // SPI 종료
-    render_quit(); // 렌더러 종료
-    bcm2835_close(); // bcm2835 라이브러리 종료
+    hal_spi_end(); // SPI 종료
+    hal_close(); // GPIO/SPI 백엔드 종료
     return 0;
 }
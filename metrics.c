@@ -0,0 +1,110 @@
+#include "metrics.h"
+
+#ifdef METRICS
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "render.h"
+
+// 단계마다 쓰는 스레드는 하나(MT_FLUSH는 전송 스레드, 나머지는 게임 스레드)라서 relaxed 원자 연산이면 충분
+typedef struct {
+    _Atomic uint64_t n, sum_ns, max_ns;
+    _Atomic uint32_t hist[MT_BUCKETS];
+} Phase;
+
+static Phase phases[MT_COUNT];
+static const char* const names[MT_COUNT] = { "input", "sim", "flush", "mirror", "wait" };
+
+static FILE* out = NULL;
+static uint64_t start_ns = 0, next_ns = 0;
+static uint32_t last_ticks = 0;
+
+uint64_t metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void metrics_scope_end(const MetricScope* s) {
+    uint64_t dt = metrics_now_ns() - s->t0;
+    Phase* p = &phases[s->ph];
+    uint64_t us = dt / 1000;
+    int b = us ? 64 - __builtin_clzll(us) : 0; // 2의 거듭제곱 칸
+    if (b >= MT_BUCKETS) b = MT_BUCKETS - 1;
+
+    atomic_fetch_add_explicit(&p->n, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p->sum_ns, dt, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p->hist[b], 1, memory_order_relaxed);
+    if (dt > atomic_load_explicit(&p->max_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&p->max_ns, dt, memory_order_relaxed);
+    }
+}
+
+void metrics_init(void) {
+    start_ns = metrics_now_ns();
+    next_ns = start_ns + METRICS_PERIOD_MS * 1000000ull;
+    const char* path = getenv("SNAKE_METRICS");
+    if (!path) return;
+    out = fopen(path, "w");
+    if (!out) perror(path);
+}
+
+static void write_line(uint32_t ticks) { // 누적값 한 줄 - 차이는 읽는 쪽에서 계산
+    RenderStats r = render_stats();
+    fprintf(out, "{\"t_ms\":%llu,\"ticks\":%u,\"frames\":%u,\"flushed\":%u,\"dropped\":%u,\"spi_bytes\":%u,\"spi_windows\":%u",
+            (unsigned long long)((metrics_now_ns() - start_ns) / 1000000), ticks, render_frames(),
+            r.frames_flushed, r.frames_dropped, r.spi_bytes, r.spi_windows);
+    for (int i = 0; i < MT_COUNT; i++) {
+        Phase* p = &phases[i];
+        fprintf(out, ",\"%s\":{\"n\":%llu,\"sum_us\":%llu,\"max_us\":%llu,\"hist\":[", names[i],
+                (unsigned long long)atomic_load_explicit(&p->n, memory_order_relaxed),
+                (unsigned long long)atomic_load_explicit(&p->sum_ns, memory_order_relaxed) / 1000,
+                (unsigned long long)atomic_load_explicit(&p->max_ns, memory_order_relaxed) / 1000);
+        for (int b = 0; b < MT_BUCKETS; b++) {
+            fprintf(out, b ? ",%u" : "%u", atomic_load_explicit(&p->hist[b], memory_order_relaxed));
+        }
+        fprintf(out, "]}");
+    }
+    fprintf(out, "}\n");
+    fflush(out); // 읽는 쪽이 바로 볼 수 있게
+}
+
+void metrics_poll(uint32_t ticks) {
+    last_ticks = ticks;
+    if (!out) return;
+    uint64_t now = metrics_now_ns();
+    if (now < next_ns) return;
+    next_ns = now + METRICS_PERIOD_MS * 1000000ull;
+    write_line(ticks);
+}
+
+static uint64_t bucket_hi_us(int b) { return b ? 1ull << b : 1; } // 칸 b의 위쪽 경계
+
+void metrics_report(void) {
+    if (out) {
+        write_line(last_ticks);
+        fclose(out);
+        out = NULL;
+    }
+    for (int i = 0; i < MT_COUNT; i++) {
+        Phase* p = &phases[i];
+        uint64_t n = atomic_load_explicit(&p->n, memory_order_relaxed);
+        if (!n) continue;
+        uint64_t acc = 0;
+        int p50 = -1, p99 = -1; // 히스토그램에서 구한 백분위 (칸 위쪽 경계)
+        for (int b = 0; b < MT_BUCKETS; b++) {
+            acc += atomic_load_explicit(&p->hist[b], memory_order_relaxed);
+            if (p50 < 0 && acc * 2 >= n) p50 = b;
+            if (p99 < 0 && acc * 100 >= n * 99) p99 = b;
+        }
+        printf("metrics: %-6s n %llu, mean %.1f us, p50 < %llu us, p99 < %llu us, max %.1f us\n", names[i],
+               (unsigned long long)n, atomic_load_explicit(&p->sum_ns, memory_order_relaxed) / 1e3 / n,
+               (unsigned long long)bucket_hi_us(p50), (unsigned long long)bucket_hi_us(p99),
+               atomic_load_explicit(&p->max_ns, memory_order_relaxed) / 1e3);
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// 프레임 단계별 시간 측정 - -DMETRICS로 빌드했을 때만 들어감 (아니면 매크로가 비어서 비용 0)
+// 단계 시간은 단조 시계로 재서 횟수/합/최대와 고정 칸 히스토그램에 누적
+// SNAKE_METRICS=파일 이면 1초마다 누적값을 JSON 한 줄로 덧붙임 - tail -f 등으로 게임을 멈추지 않고 읽을 수 있음
+
+typedef enum {
+    MT_INPUT,  // 버튼 이벤트 처리 (handle_input)
+    MT_SIM,    // 틱 하나 (tick_move)
+    MT_FLUSH,  // 바뀐 영역을 TFT로 전송 (전송 스레드 또는 render_present)
+    MT_MIRROR, // SDL 미러 텍스처 갱신 + 표시
+    MT_WAIT,   // 다음 틱/입력까지 대기
+    MT_COUNT
+} MetricPhase;
+
+#define MT_BUCKETS 16 // 히스토그램 칸 i: [2^(i-1), 2^i) us (0번은 1 us 미만, 마지막 칸은 그 이상 전부)
+#define METRICS_PERIOD_MS 1000 // 파일에 한 줄 쓰는 간격
+
+#ifdef METRICS
+
+typedef struct { MetricPhase ph; uint64_t t0; } MetricScope;
+
+uint64_t metrics_now_ns(void);
+void metrics_scope_end(const MetricScope* s); // METRIC_SCOPE가 블록을 나갈 때 자동 호출
+
+void metrics_init(void); // SNAKE_METRICS 파일 열기
+void metrics_poll(uint32_t ticks); // 게임 루프에서 매번 호출 - 간격이 지났으면 한 줄 씀
+void metrics_report(void); // 마지막 줄을 쓰고 닫은 뒤 단계별 요약 출력
+
+#define MT_CAT_(a, b) a##b
+#define MT_CAT(a, b) MT_CAT_(a, b)
+// 이 줄부터 블록 끝까지의 시간을 ph에 더함
+#define METRIC_SCOPE(ph) \
+    MetricScope MT_CAT(mt_scope_, __LINE__) __attribute__((cleanup(metrics_scope_end))) = { (ph), metrics_now_ns() }
+
+#else
+
+#define METRIC_SCOPE(ph) ((void)0)
+#define metrics_init() ((void)0)
+#define metrics_poll(ticks) ((void)(ticks))
+#define metrics_report() ((void)0)
+
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+// pixops.c가 쓰는 NEON 인트린식만 스칼라 C로 흉내 낸 헤더 - ARM 컴파일러가 없는 PC에서 NEON 경로의 논리를 검사할 때만 씀
+// gcc -O2 -D__ARM_NEON -Ineon_emul -o pixops_check pixops_check.c pixops.c
+// 레인 순서는 리틀 엔디언 AArch64/ARMv7과 같음 (레인 0 = 가장 낮은 주소). 실제 명령의 타이밍/정렬은 흉내 내지 않음
+// pixops.c에 새 인트린식을 쓰면 여기에도 추가해야 빌드됨
+
+#include <stdint.h>
+#include <string.h>
+
+typedef struct { uint8_t v[8]; } uint8x8_t;
+typedef struct { uint8_t v[16]; } uint8x16_t;
+typedef struct { uint16_t v[8]; } uint16x8_t;
+typedef struct { uint8x8_t val[2]; } uint8x8x2_t;
+
+static inline uint8x8_t vld1_u8(const uint8_t* p) {
+    uint8x8_t r;
+    memcpy(r.v, p, 8);
+    return r;
+}
+
+static inline uint16x8_t vld1q_u16(const uint16_t* p) {
+    uint16x8_t r;
+    memcpy(r.v, p, 16);
+    return r;
+}
+
+static inline void vst1q_u8(uint8_t* p, uint8x16_t a) { memcpy(p, a.v, 16); }
+static inline void vst1q_u16(uint16_t* p, uint16x8_t a) { memcpy(p, a.v, 16); }
+
+static inline void vst2_u8(uint8_t* p, uint8x8x2_t a) { // 두 벡터를 레인마다 번갈아 저장
+    for (int i = 0; i < 8; i++) {
+        p[i * 2] = a.val[0].v[i];
+        p[i * 2 + 1] = a.val[1].v[i];
+    }
+}
+
+static inline uint8x8_t vdup_n_u8(uint8_t x) {
+    uint8x8_t r;
+    memset(r.v, x, 8);
+    return r;
+}
+
+static inline uint16x8_t vdupq_n_u16(uint16_t x) {
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++) r.v[i] = x;
+    return r;
+}
+
+static inline uint8x16_t vreinterpretq_u8_u16(uint16x8_t a) { // 리틀 엔디언 메모리 표현 그대로
+    uint8x16_t r;
+    memcpy(r.v, a.v, 16);
+    return r;
+}
+
+static inline uint8x16_t vrev16q_u8(uint8x16_t a) { // 16비트 원소마다 두 바이트 뒤집기
+    uint8x16_t r;
+    for (int i = 0; i < 16; i += 2) {
+        r.v[i] = a.v[i + 1];
+        r.v[i + 1] = a.v[i];
+    }
+    return r;
+}
+
+static inline uint8x8_t vshr_n_u8(uint8x8_t a, int n) {
+    for (int i = 0; i < 8; i++) a.v[i] = (uint8_t)(a.v[i] >> n);
+    return a;
+}
+
+static inline uint8x8_t vand_u8(uint8x8_t a, uint8x8_t b) {
+    for (int i = 0; i < 8; i++) a.v[i] &= b.v[i];
+    return a;
+}
+
+static inline uint8x8x2_t vzip_u8(uint8x8_t a, uint8x8_t b) { // a0 b0 a1 b1 ... a7 b7 을 두 벡터로
+    uint8x8x2_t r;
+    for (int i = 0; i < 8; i++) {
+        r.val[i / 4].v[(i % 4) * 2] = a.v[i];
+        r.val[i / 4].v[(i % 4) * 2 + 1] = b.v[i];
+    }
+    return r;
+}
+
+static inline uint8x8_t vtbl2_u8(uint8x8x2_t t, uint8x8_t idx) { // 16칸 표 조회 - 범위 밖 인덱스는 0
+    uint8x8_t r;
+    for (int i = 0; i < 8; i++) r.v[i] = idx.v[i] < 16 ? t.val[idx.v[i] / 8].v[idx.v[i] % 8] : 0;
+    return r;
+}
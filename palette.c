@@ -0,0 +1,124 @@
+#include "palette.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "pixops.h"
+
+static uint16_t pal[PAL_SIZE];
+static int pal_n = 0;
+static uint16_t last_color = 0; // 마지막으로 찾은 색 - 같은 색을 연속으로 칠할 때가 대부분
+static uint8_t last_idx = 0;
+static int frozen = 0; // pal_freeze 이후 - 표를 다시 만들지 않음
+
+static uint8_t t565be[256][4]; // 바이트(두 픽셀) -> big-endian RGB565 4바이트
+static uint8_t t444[256][3];   // 바이트(두 픽셀) -> RGB444 3바이트
+static uint16_t t565[256][2];  // 바이트(두 픽셀) -> 네이티브 RGB565 두 개
+static uint8_t pal_hi[16], pal_lo[16]; // 인덱스 -> RGB565 상위/하위 바이트 (SIMD 표 조회용)
+
+static void to444(uint16_t c, uint8_t* r, uint8_t* g, uint8_t* b) {
+    *r = (c >> 12) & 0x0F; // R5 상위 4비트
+    *g = (c >> 7) & 0x0F;  // G6 상위 4비트
+    *b = (c >> 1) & 0x0F;  // B5 상위 4비트
+}
+
+static void build_entry(int v) { // 바이트 값 v에 대한 표 항목 채우기
+    uint16_t a = pal[v >> 4], b = pal[v & 0x0F];
+    t565be[v][0] = a >> 8; t565be[v][1] = a & 0xFF;
+    t565be[v][2] = b >> 8; t565be[v][3] = b & 0xFF;
+
+    uint8_t r1, g1, b1, r2, g2, b2;
+    to444(a, &r1, &g1, &b1);
+    to444(b, &r2, &g2, &b2);
+    t444[v][0] = (uint8_t)((r1 << 4) | g1);
+    t444[v][1] = (uint8_t)((b1 << 4) | r2);
+    t444[v][2] = (uint8_t)((g2 << 4) | b2);
+
+    t565[v][0] = a;
+    t565[v][1] = b;
+}
+
+static uint8_t add_color(uint16_t c) { // 새 색 등록 - 새 인덱스가 들어간 항목만 다시 만듦
+    uint8_t idx = (uint8_t)pal_n++;
+    pal[idx] = c;
+    pal_hi[idx] = c >> 8;
+    pal_lo[idx] = c & 0xFF;
+    for (int o = 0; o < PAL_SIZE; o++) {
+        build_entry((idx << 4) | o);
+        build_entry((o << 4) | idx);
+    }
+    return idx;
+}
+
+void pal_init(void) {
+    static const uint16_t base[] = { C_BLACK, C_WHITE, C_RED, C_GREEN, C_BLUE, C_YELLOW, C_DKGREEN, C_NAVY, C_DKRED };
+    pal_n = 0;
+    memset(pal, 0, sizeof(pal));
+    memset(pal_hi, 0, sizeof(pal_hi));
+    memset(pal_lo, 0, sizeof(pal_lo));
+    for (unsigned i = 0; i < sizeof(base) / sizeof(base[0]); i++) add_color(base[i]);
+    for (int v = 0; v < 256; v++) build_entry(v);
+    last_color = pal[0];
+    last_idx = 0;
+    frozen = 0;
+}
+
+void pal_freeze(void) {
+    frozen = 1;
+}
+
+static int dist(uint16_t a, uint16_t b) { // 색 거리 (채널별 차이 제곱합)
+    int dr = ((a >> 11) & 0x1F) - ((b >> 11) & 0x1F);
+    int dg = (((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)) / 2;
+    int db = (a & 0x1F) - (b & 0x1F);
+    return dr * dr + dg * dg + db * db;
+}
+
+uint8_t pal_index(uint16_t c) {
+    if (c == last_color) return last_idx;
+    int best = -1;
+    for (int i = 0; i < pal_n && best < 0; i++) if (pal[i] == c) best = i;
+    if (best < 0 && pal_n < PAL_SIZE && !frozen) best = add_color(c);
+    if (best < 0 && frozen) { // 다른 스레드가 표를 읽는 중 - 새 색은 받지 않음 (시작할 때 그리지 않은 색)
+        static int warned = 0;
+        if (!warned++) printf("palette: colour 0x%04X first used after pal_freeze - drawn as the nearest entry\n", c);
+    }
+    if (best < 0) { // 꽉 참 - 가장 가까운 색
+        best = 0;
+        for (int i = 1; i < pal_n; i++) if (dist(pal[i], c) < dist(pal[best], c)) best = i;
+    }
+    last_color = c;
+    last_idx = (uint8_t)best;
+    return last_idx;
+}
+
+uint16_t pal_color(uint8_t idx) {
+    return pal[idx & 0x0F];
+}
+
+void pal_expand_565be(uint8_t* dst, const uint8_t* src, int pairs) {
+#if PX_TBL
+    px_expand4(dst, src, (uint32_t)pairs, pal_hi, pal_lo);
+#else
+    for (int i = 0; i < pairs; i++, dst += 4) memcpy(dst, t565be[src[i]], 4);
+#endif
+}
+
+void pal_expand_444(uint8_t* dst, const uint8_t* src, int pairs) {
+    for (int i = 0; i < pairs; i++, dst += 3) memcpy(dst, t444[src[i]], 3);
+}
+
+void pal_expand_565(uint16_t* dst, const uint8_t* src, int pairs) {
+#if PX_TBL && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    px_expand4((uint8_t*)dst, src, (uint32_t)pairs, pal_lo, pal_hi); // 리틀 엔디언: 하위 바이트가 먼저
+#else
+    for (int i = 0; i < pairs; i++, dst += 2) memcpy(dst, t565[src[i]], 4);
+#endif
+}
+
+uint16_t pal_quantize444(uint16_t c) {
+    uint8_t r, g, b;
+    to444(c, &r, &g, &b);
+    return (uint16_t)(((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3)); // 4비트를 상위 비트 반복으로 넓힘 (hal_host 디코딩과 같음)
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+// 4비트 팔레트: 프레임버퍼는 픽셀당 4비트 인덱스(바이트 하나에 두 픽셀, 왼쪽 픽셀이 상위 4비트)
+// 전송할 때 표(256칸 = 바이트 하나가 담은 두 픽셀 조합)로 한 번에 펼침
+
+#define PAL_SIZE 16
+
+void pal_init(void); // config.h 색상으로 초기화
+uint8_t pal_index(uint16_t rgb565); // 색 -> 인덱스 (처음 보는 색은 빈 칸에 추가, 꽉 찼거나 얼린 뒤면 가장 가까운 색)
+void pal_freeze(void); // 첫 프레임 전에 - 이후 색/표는 읽기 전용 (전송 스레드, 캡처 기록 스레드가 락 없이 펼침)
+uint16_t pal_color(uint8_t idx);
+
+// 두 픽셀(바이트 하나)씩 펼치는 커널 - pairs는 바이트 수
+void pal_expand_565be(uint8_t* dst, const uint8_t* src, int pairs); // big-endian RGB565, 바이트당 4바이트 (COLMOD 0x55)
+void pal_expand_444(uint8_t* dst, const uint8_t* src, int pairs);   // RGB444 두 픽셀을 3바이트로 (COLMOD 0x53)
+void pal_expand_565(uint16_t* dst, const uint8_t* src, int pairs);  // 네이티브 RGB565 (SDL 미러)
+
+uint16_t pal_quantize444(uint16_t rgb565); // 12비트 모드로 보냈을 때 패널이 보여 주는 RGB565
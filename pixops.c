@@ -0,0 +1,129 @@
+#include "pixops.h"
+
+#if defined(PX_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(PX_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(PX_SSSE3)
+#include <tmmintrin.h>
+#endif
+#if defined(PX_AVX2)
+#include <immintrin.h>
+#endif
+
+const char* px_impl(void) {
+#if defined(PX_NEON)
+    return "neon";
+#elif defined(PX_AVX2)
+    return "avx2";
+#elif defined(PX_SSSE3)
+    return "ssse3";
+#elif defined(PX_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+static inline uint16_t bswap16(uint16_t c) { return (uint16_t)((c << 8) | (c >> 8)); }
+
+void px_fill(uint16_t* dst, uint16_t c, uint32_t n) {
+    uint32_t i = 0;
+#if defined(PX_NEON)
+    uint16x8_t v = vdupq_n_u16(c);
+    for (; i + 8 <= n; i += 8) vst1q_u16(dst + i, v);
+#elif defined(PX_AVX2)
+    __m256i v = _mm256_set1_epi16((short)c);
+    for (; i + 16 <= n; i += 16) _mm256_storeu_si256((__m256i*)(dst + i), v);
+#elif defined(PX_SSE2)
+    __m128i v = _mm_set1_epi16((short)c);
+    for (; i + 8 <= n; i += 8) _mm_storeu_si128((__m128i*)(dst + i), v);
+#endif
+    for (; i < n; i++) dst[i] = c; // 나머지 (또는 스칼라 전체)
+}
+
+void px_fill_be(uint8_t* dst, uint16_t c, uint32_t n) {
+    uint32_t i = 0;
+#if defined(PX_NEON)
+    uint8x16_t v = vreinterpretq_u8_u16(vdupq_n_u16(c));
+    v = vrev16q_u8(v); // 픽셀마다 두 바이트 뒤집기
+    for (; i + 8 <= n; i += 8) vst1q_u8(dst + i * 2, v);
+#elif defined(PX_SSE2)
+    uint8_t hi = c >> 8, lo = c & 0xFF;
+    __m128i v = _mm_set1_epi16((short)(hi | (lo << 8))); // 메모리에 hi, lo 순서로 놓이는 값 (리틀 엔디언)
+    for (; i + 8 <= n; i += 8) _mm_storeu_si128((__m128i*)(dst + i * 2), v);
+#endif
+    for (; i < n; i++) {
+        dst[i * 2] = c >> 8;
+        dst[i * 2 + 1] = c & 0xFF;
+    }
+}
+
+void px_swap_be(uint8_t* dst, const uint16_t* src, uint32_t n) {
+    uint32_t i = 0;
+#if defined(PX_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint8x16_t v = vreinterpretq_u8_u16(vld1q_u16(src + i));
+        vst1q_u8(dst + i * 2, vrev16q_u8(v));
+    }
+#elif defined(PX_AVX2)
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+        _mm256_storeu_si256((__m256i*)(dst + i * 2), v);
+    }
+#elif defined(PX_SSE2)
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)); // 리틀 엔디언 u16의 바이트 교환
+        _mm_storeu_si128((__m128i*)(dst + i * 2), v);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i * 2] = src[i] >> 8;
+        dst[i * 2 + 1] = src[i] & 0xFF;
+    }
+}
+
+void px_expand4(uint8_t* dst, const uint8_t* src, uint32_t pairs, const uint8_t t0[16], const uint8_t t1[16]) {
+    uint32_t i = 0;
+#if defined(PX_NEON)
+    // 8바이트(16픽셀)씩: 니블을 인덱스로 표 조회(vtbl2) 후 t0/t1 바이트를 번갈아 저장
+    uint8x8x2_t a = { { vld1_u8(t0), vld1_u8(t0 + 8) } };
+    uint8x8x2_t b = { { vld1_u8(t1), vld1_u8(t1 + 8) } };
+    for (; i + 8 <= pairs; i += 8) {
+        uint8x8_t s = vld1_u8(src + i);
+        uint8x8x2_t idx = vzip_u8(vshr_n_u8(s, 4), vand_u8(s, vdup_n_u8(0x0F))); // 픽셀 순서 인덱스 16개
+        uint8x8x2_t p0 = { { vtbl2_u8(a, idx.val[0]), vtbl2_u8(b, idx.val[0]) } };
+        uint8x8x2_t p1 = { { vtbl2_u8(a, idx.val[1]), vtbl2_u8(b, idx.val[1]) } };
+        vst2_u8(dst + i * 4, p0); // t0, t1 번갈아
+        vst2_u8(dst + i * 4 + 16, p1);
+    }
+#elif defined(PX_SSSE3)
+    // 16바이트(32픽셀)씩: pshufb로 16칸 표 조회
+    __m128i ta = _mm_loadu_si128((const __m128i*)t0);
+    __m128i tb = _mm_loadu_si128((const __m128i*)t1);
+    __m128i m = _mm_set1_epi8(0x0F);
+    for (; i + 16 <= pairs; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(s, 4), m);
+        __m128i lo = _mm_and_si128(s, m);
+        __m128i idx[2] = { _mm_unpacklo_epi8(hi, lo), _mm_unpackhi_epi8(hi, lo) }; // 픽셀 순서 인덱스 32개
+        for (int k = 0; k < 2; k++) {
+            __m128i pa = _mm_shuffle_epi8(ta, idx[k]);
+            __m128i pb = _mm_shuffle_epi8(tb, idx[k]);
+            _mm_storeu_si128((__m128i*)(dst + i * 4 + k * 32), _mm_unpacklo_epi8(pa, pb));
+            _mm_storeu_si128((__m128i*)(dst + i * 4 + k * 32 + 16), _mm_unpackhi_epi8(pa, pb));
+        }
+    }
+#endif
+    for (; i < pairs; i++) { // 나머지 (표 조회 명령이 없으면 전체)
+        uint8_t a = src[i] >> 4, b = src[i] & 0x0F;
+        dst[i * 4] = t0[a];
+        dst[i * 4 + 1] = t1[a];
+        dst[i * 4 + 2] = t0[b];
+        dst[i * 4 + 3] = t1[b];
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+// 픽셀 커널 - 컴파일할 때 NEON(라즈베리파이) / SSE2·SSSE3·AVX2(x86) / 스칼라 중 하나를 고름
+// -DPIXOPS_SCALAR로 빌드하면 항상 스칼라 (비교용)
+// 모든 구현은 스칼라와 비트 단위로 같은 결과를 냄
+
+#if defined(PIXOPS_SCALAR)
+// 스칼라 고정
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PX_NEON 1
+#elif defined(__SSE2__)
+#define PX_SSE2 1
+#if defined(__SSSE3__)
+#define PX_SSSE3 1
+#endif
+#if defined(__AVX2__)
+#define PX_AVX2 1
+#endif
+#endif
+
+#if defined(PX_NEON) || defined(PX_SSSE3)
+#define PX_TBL 1 // 16칸 표 조회 명령(vtbl/pshufb)이 있음 - 없으면 px_expand4보다 256칸 표가 빠름
+#else
+#define PX_TBL 0
+#endif
+
+const char* px_impl(void); // 선택된 구현 이름 ("neon", "avx2", "ssse3", "sse2", "scalar")
+
+void px_fill(uint16_t* dst, uint16_t c, uint32_t n); // 네이티브 RGB565 n픽셀 채우기 (스팬 채우기)
+void px_fill_be(uint8_t* dst, uint16_t c, uint32_t n); // big-endian RGB565 n픽셀 채우기 (SPI 버퍼)
+void px_swap_be(uint8_t* dst, const uint16_t* src, uint32_t n); // 네이티브 RGB565 -> big-endian 바이트
+
+// 4비트 인덱스 펼치기: 바이트 하나(두 픽셀, 상위 4비트가 왼쪽) -> 픽셀마다 t0[idx], t1[idx] 두 바이트
+// t0 = 상위 바이트 표, t1 = 하위 바이트 표면 big-endian RGB565, 바꿔 넣으면 리틀 엔디언 네이티브 RGB565
+void px_expand4(uint8_t* dst, const uint8_t* src, uint32_t pairs, const uint8_t t0[16], const uint8_t t1[16]);
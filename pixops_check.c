@@ -0,0 +1,156 @@
+// 픽셀 커널 검사/측정(별도 프로그램) - px_* 커널을 스칼라 루프와 비교하고 커널마다 초당 픽셀 수를 출력
+// 길이 0..300(벡터 폭의 배수 + 홀수 꼬리)과 어긋난 시작 주소를 모두 돌리고, 끝 뒤를 덮어쓰지 않는지도 확인
+//
+// gcc -O2 -o pixops_check pixops_check.c pixops.c                      # 이 CPU 기본(SSE2)
+// gcc -O2 -march=native -o pixops_check pixops_check.c pixops.c        # SSSE3/AVX2
+// gcc -O2 -DPIXOPS_SCALAR -o pixops_check pixops_check.c pixops.c      # 스칼라 기준
+// gcc -O2 -D__ARM_NEON -Ineon_emul -o pixops_check pixops_check.c pixops.c  # NEON 경로를 x86에서 (neon_emul/arm_neon.h)
+// ./pixops_check [커널/길이마다 측정 ms]   # 어긋나면 첫 차이를 출력하고 1로 끝남
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pixops.h"
+
+#define MAX_N 300   // 검사 길이 상한 - 가장 넓은 벡터(AVX2 16픽셀, SSSE3 32픽셀)의 여러 배 + 꼬리
+#define SLACK 64    // 시작 주소 어긋남과 끝 뒤 가드
+#define GUARD 0xA5
+#define BENCH_MAX_PX 57600 // 240x240 한 화면
+
+static int failures = 0;
+
+// 기준: pixops.c의 꼬리 루프와 같은 스칼라
+static void ref_fill(uint16_t* dst, uint16_t c, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) dst[i] = c;
+}
+
+static void ref_fill_be(uint8_t* dst, uint16_t c, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        dst[i * 2] = c >> 8;
+        dst[i * 2 + 1] = c & 0xFF;
+    }
+}
+
+static void ref_swap_be(uint8_t* dst, const uint16_t* src, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        dst[i * 2] = src[i] >> 8;
+        dst[i * 2 + 1] = src[i] & 0xFF;
+    }
+}
+
+static void ref_expand4(uint8_t* dst, const uint8_t* src, uint32_t pairs, const uint8_t t0[16], const uint8_t t1[16]) {
+    for (uint32_t i = 0; i < pairs; i++) {
+        uint8_t a = src[i] >> 4, b = src[i] & 0x0F;
+        dst[i * 4] = t0[a];
+        dst[i * 4 + 1] = t1[a];
+        dst[i * 4 + 2] = t0[b];
+        dst[i * 4 + 3] = t1[b];
+    }
+}
+
+static uint32_t rnd_state = 12345;
+static uint8_t rnd8(void) { // xorshift - 실행마다 같은 입력
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return (uint8_t)rnd_state;
+}
+
+static void compare(const char* kernel, uint32_t n, int off, const uint8_t* got, const uint8_t* want, size_t bytes) {
+    for (size_t i = 0; i < bytes + SLACK; i++) { // 끝 뒤 SLACK 바이트는 가드 그대로여야 함
+        if (got[i] == want[i]) continue;
+        printf("FAIL %s n=%u offset %d: byte %zu is %02X, want %02X%s\n", kernel, n, off, i, got[i], want[i],
+               i >= bytes ? " (past the end)" : "");
+        failures++;
+        return;
+    }
+}
+
+static void check_all(void) {
+    static _Alignas(64) uint8_t got[MAX_N * 4 + 2 * SLACK], want[MAX_N * 4 + 2 * SLACK];
+    static uint8_t src_bytes[MAX_N * 2 + SLACK];
+    uint8_t t0[16], t1[16];
+    for (int i = 0; i < 16; i++) {
+        t0[i] = rnd8();
+        t1[i] = rnd8();
+    }
+    for (uint32_t n = 0; n <= MAX_N; n++) {
+        for (int off = 0; off < 4; off++) { // 바이트 단위로 어긋난 dst/src (uint16_t는 2바이트 단위)
+            uint16_t c = (uint16_t)(rnd8() << 8 | rnd8());
+            for (size_t i = 0; i < sizeof(src_bytes); i++) src_bytes[i] = rnd8();
+            uint16_t src16[MAX_N + 8];
+            memcpy(src16, src_bytes, sizeof(src16));
+
+            memset(got, GUARD, sizeof(got));
+            memset(want, GUARD, sizeof(want));
+            px_fill((uint16_t*)(got + off * 2), c, n);
+            ref_fill((uint16_t*)(want + off * 2), c, n);
+            compare("px_fill", n, off, got, want, off * 2 + n * 2);
+
+            memset(got, GUARD, sizeof(got));
+            memset(want, GUARD, sizeof(want));
+            px_fill_be(got + off, c, n);
+            ref_fill_be(want + off, c, n);
+            compare("px_fill_be", n, off, got, want, off + n * 2);
+
+            memset(got, GUARD, sizeof(got));
+            memset(want, GUARD, sizeof(want));
+            px_swap_be(got + off, src16 + off, n);
+            ref_swap_be(want + off, src16 + off, n);
+            compare("px_swap_be", n, off, got, want, off + n * 2);
+
+            memset(got, GUARD, sizeof(got));
+            memset(want, GUARD, sizeof(want));
+            px_expand4(got + off, src_bytes + off, n, t0, t1); // n = 바이트 수 (픽셀 2n개)
+            ref_expand4(want + off, src_bytes + off, n, t0, t1);
+            compare("px_expand4", n, off, got, want, off + n * 4);
+        }
+    }
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 커널마다 같은 길이(픽셀)를 ms 동안 반복 - 결과 바이트를 합쳐서 루프가 없어지지 않게 함
+static volatile uint32_t sink;
+
+static void bench(const char* kernel, int which, uint32_t px, int ms) {
+    static _Alignas(64) uint8_t dst[BENCH_MAX_PX * 2];
+    static _Alignas(64) uint8_t src[BENCH_MAX_PX * 2];
+    static uint8_t t0[16], t1[16];
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = rnd8();
+    uint64_t reps = 0;
+    double t0s = now_sec(), t;
+    do {
+        for (int k = 0; k < 64; k++, reps++) {
+            switch (which) {
+            case 0: px_fill((uint16_t*)dst, (uint16_t)reps, px); break;
+            case 1: px_fill_be(dst, (uint16_t)reps, px); break;
+            case 2: px_swap_be(dst, (const uint16_t*)src, px); break;
+            default: px_expand4(dst, src, px / 2, t0, t1); break;
+            }
+            sink += dst[reps % 7];
+        }
+        t = now_sec() - t0s;
+    } while (t * 1000 < ms);
+    printf("  %-10s %6u px: %8.0f Mpx/s\n", kernel, px, reps * (double)px / t / 1e6);
+}
+
+int main(int argc, char** argv) {
+    int ms = argc > 1 ? atoi(argv[1]) : 50;
+    check_all();
+    printf(failures ? "pixops (%s): %d FAILED\n" : "pixops (%s): bit-exact with scalar, n = 0..%d, 4 offsets\n", px_impl(),
+           failures ? failures : MAX_N);
+    if (failures) return 1;
+
+    static const char* const names[] = { "px_fill", "px_fill_be", "px_swap_be", "px_expand4" };
+    static const uint32_t sizes[] = { 20, 240, 57600 }; // 칸 한 줄, 화면 한 줄, 240x240 전체
+    for (int s = 0; s < 3; s++)
+        for (int k = 0; k < 4; k++) bench(names[k], k, sizes[s], ms);
+    return 0;
+}
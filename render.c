@@ -1,24 +1,61 @@
 #include "render.h"
 
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef NO_SDL
 #include <SDL2/SDL.h>
+#endif
 
+#include "arena.h"
 #include "config.h"
+#include "dirty.h"
+#include "framecap.h"
+#include "hal.h"
+#include "metrics.h"
+#include "palette.h"
+#include "pixops.h"
 #include "st7789.h"
 
+#define FB_STRIDE (ST7789_TFTWIDTH / 2) // 프레임버퍼 한 줄 바이트 수 (픽셀당 4비트)
+
+// 이중 버퍼: 게임 스레드는 fb(뒤 버퍼)에 프레임 N을 그리고,
+// 전송 스레드는 front(앞 버퍼)의 프레임 N-1을 TFT로 보냄
+// 픽셀은 4비트 팔레트 인덱스 - 버퍼 하나 28.8 KB (240x240), 38.4 KB (320x240), 전송할 때 palette.c 표로 펼침
+// 버퍼는 패널 크기가 정해진 뒤 render_alloc이 아레나에서 한 번 받음
+static Arena mem;
+static uint8_t* fbs[2];
+static uint8_t* fb = NULL; // 게임 스레드가 그리는 프레임버퍼
+static uint8_t* scratch = NULL; // 화면 밖 그리기용 (render_capture_begin)
+static uint8_t* enc = NULL; // RLE 압축 작업 버퍼 - 최악의 경우: 픽셀마다 run 하나
+static DirtyList dirty; // 이번 프레임에 바뀐 영역 (마지막 넘겨준 뒤로 누적)
+static uint8_t* screen_fb = NULL; // 화면 밖에 그리는 중이면 원래 fb (render_capture_begin)
+static uint32_t frames = 0; // render_present 호출 횟수
+
+static pthread_t flusher;
+static pthread_mutex_t flush_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_cv = PTHREAD_COND_INITIALIZER;
+static const uint8_t* front = NULL; // 전송 중인 버퍼
+static DirtyList front_dirty;        // 전송할 영역
+static int inflight = 0;             // 1이면 front 전송 중 - 끝나야 다음 프레임을 넘길 수 있음
+static int flush_running = 0;
+static int threaded = 0;
+static RenderStats rstats;
+
+static Rect align_even(const Rect* r) { // 두 픽셀이 한 바이트이므로 x를 짝수 경계로 넓힘 (12비트 모드도 두 픽셀 단위)
+    int x0 = r->x & ~1;
+    int x1 = (r->x + r->w + 1) & ~1;
+    return (Rect){ (int16_t)x0, r->y, (int16_t)(x1 - x0), r->h };
+}
+
+#ifndef NO_SDL
 static SDL_Window* win = NULL;
 static SDL_Renderer* ren = NULL;
 static SDL_Texture* tex = NULL;
-static uint32_t mirror_rgba[ST7789_TFTWIDTH * ST7789_TFTHEIGHT];
-
-static uint32_t rgb565_to_rgba8888(uint16_t c) { // RGB565를 ARGB8888로 변환 TFT -> 미러링
-    uint8_t r = (c >> 11) & 0x1F;
-    uint8_t g = (c >> 5)  & 0x3F;
-    uint8_t b = (c >> 0)  & 0x1F;
-    r = (r << 3) | (r >> 2);
-    g = (g << 2) | (g >> 4);
-    b = (b << 3) | (b >> 2);
-    return (0xFFu << 24) | (r << 16) | (g << 8) | b;
-}
+static int mirror_stale = 1; // 창이 다시 그려져야 하면 1 (처음, 가려졌다 보임 등)
 
 static int mirror_init(void) { // SDL 미러 렌더러 초기화
     if (SDL_Init(SDL_INIT_VIDEO) != 0) return 0;
@@ -31,7 +68,7 @@ static int mirror_init(void) { // SDL 미러 렌더러 초기화
     ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
     if (!ren) return 0;
 
-    tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888,
+    tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGB565, // TFT와 같은 RGB565 - 팔레트 표로 바로 펼쳐 넣음
                             SDL_TEXTUREACCESS_STREAMING,
                             ST7789_TFTWIDTH, ST7789_TFTHEIGHT);
     if (!tex) return 0;
@@ -46,35 +83,206 @@ static void mirror_quit(void) { // 렌더러 종료
     SDL_Quit();
 }
 
-static void mirror_fillRect(int x, int y, int w, int h, uint16_t color) { // 미러링에 사각형 그리기
-    if (x < 0 || y < 0) return;
-    if (x + w > ST7789_TFTWIDTH)  w = ST7789_TFTWIDTH - x;
-    if (y + h > ST7789_TFTHEIGHT) h = ST7789_TFTHEIGHT - y;
+static void mirror_update(const Rect* r) { // 바뀐 영역만 텍스처 메모리에 바로 펼침 - 중간 버퍼 없음
+    if (!tex) return;
+    METRIC_SCOPE(MT_MIRROR);
+    Rect a = align_even(r);
+    SDL_Rect sr = { a.x, a.y, a.w, a.h };
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(tex, &sr, &pixels, &pitch) != 0) return;
+    for (int yy = 0; yy < a.h; yy++) {
+        pal_expand_565((uint16_t*)((uint8_t*)pixels + yy * pitch), &fb[(a.y + yy) * FB_STRIDE + a.x / 2], a.w / 2);
+    }
+    SDL_UnlockTexture(tex);
+    mirror_stale = 1;
+}
 
-    uint32_t rgba = rgb565_to_rgba8888(color);
+static void mirror_present(void) { // 바뀐 게 있을 때만 화면 표시
+    if (!tex || !mirror_stale) return;
+    METRIC_SCOPE(MT_MIRROR);
+    SDL_RenderClear(ren);
+    SDL_RenderCopy(ren, tex, NULL, NULL);
+    SDL_RenderPresent(ren);
+    mirror_stale = 0;
+}
+
+#else
+// -DNO_SDL: 미러 없이 TFT(또는 호스트 백엔드)만 사용
+static int mirror_init(void) { return 1; }
+static void mirror_quit(void) {}
+static void mirror_update(const Rect* r) { (void)r; }
+static void mirror_present(void) {}
+#endif
+
+static inline void fb_put(uint8_t* row, int x, uint8_t idx) { // 픽셀 하나 쓰기 - 짝수 x는 상위 4비트
+    uint8_t* p = &row[x >> 1];
+    *p = (x & 1) ? (uint8_t)((*p & 0xF0) | idx) : (uint8_t)((*p & 0x0F) | (idx << 4));
+}
+
+static void mark(int x, int y, int w, int h) { // 바뀐 영역 기록 - 화면 밖에 그릴 때는 안 함
+    if (!screen_fb) dirty_add(&dirty, x, y, w, h);
+}
+
+static inline uint8_t fb_get(const uint8_t* row, int x) { // 픽셀 하나 읽기
+    uint8_t b = row[x >> 1];
+    return (x & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+static void fb_fillRect(int x, int y, int w, int h, uint16_t color) { // 프레임버퍼에 사각형 그리기
+    uint8_t idx = pal_index(color);
     for (int yy = y; yy < y + h; yy++) {
-        uint32_t* row = &mirror_rgba[yy * ST7789_TFTWIDTH];
-        for (int xx = x; xx < x + w; xx++) row[xx] = rgba;
+        uint8_t* row = &fb[yy * FB_STRIDE];
+        int x0 = x, x1 = x + w;
+        if (x0 & 1) fb_put(row, x0++, idx); // 홀수 시작 픽셀
+        if ((x1 & 1) && x1 > x0) fb_put(row, --x1, idx); // 홀수 끝 픽셀
+        if (x1 > x0) memset(&row[x0 >> 1], idx * 0x11, (size_t)(x1 - x0) >> 1); // 가운데는 바이트 단위
+    }
+    mark(x, y, w, h);
+}
+
+static uint64_t mono_us(void) { // 전송 시간 측정용 실제 시계
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static uint64_t panel_flush(const uint8_t* buf, const DirtyList* d) { // 바뀐 영역만 TFT로 전송 - 영역마다 창 1개
+    static uint8_t out[ST7789_MAX_DIM * 2]; // 펼친 픽셀을 모아 한 번에 보내는 버퍼 (가장 넓은 회전의 16비트 한 줄)
+    METRIC_SCOPE(MT_FLUSH);
+    uint64_t t0 = mono_us();
+    for (int i = 0; i < d->n; i++) {
+        Rect r = align_even(&d->r[i]);
+        int pairs = r.w / 2;
+        int row_bytes = PANEL_BPP == 12 ? pairs * 3 : pairs * 4;
+        int n = 0;
+        st7789_setWindow(r.x, r.y, r.x + r.w - 1, r.y + r.h - 1);
+        for (int yy = r.y; yy < r.y + r.h; yy++) {
+            if (n + row_bytes > (int)sizeof(out)) { st7789_pushBytes(out, n); n = 0; }
+            const uint8_t* src = &buf[yy * FB_STRIDE + r.x / 2];
+            if (PANEL_BPP == 12) pal_expand_444(&out[n], src, pairs);
+            else pal_expand_565be(&out[n], src, pairs);
+            n += row_bytes;
+        }
+        if (n > 0) st7789_pushBytes(out, n);
     }
+    st7789_flush(); // spidev 백엔드는 여기까지 모아서 보냄
+    return mono_us() - t0;
+}
+
+static void note_flush(uint64_t us) { // 전송 통계 기록 (스레드 모드에서는 flush_mu 잡고 호출)
+    rstats.flush_last_us = us;
+    if (us > rstats.flush_max_us) rstats.flush_max_us = us;
+    rstats.flush_total_us += us;
+    rstats.frames_flushed++;
+    rstats.spi_bytes = st7789_stats()->bytes; // 전송하는 스레드에서 읽어 두면 게임 스레드가 락 잡고 볼 수 있음
+    rstats.spi_windows = st7789_stats()->windows;
 }
- 
-static void mirror_fillScreen(uint16_t color) { // 미러링에 화면 전체 채우기
-    uint32_t rgba = rgb565_to_rgba8888(color);
-    for (int i = 0; i < ST7789_TFTWIDTH * ST7789_TFTHEIGHT; i++) {
-        mirror_rgba[i] = rgba;
+
+static void* flusher_main(void* arg) { // 전송 스레드: 넘겨받은 프레임을 TFT로 보냄
+    (void)arg;
+    pthread_mutex_lock(&flush_mu);
+    while (1) {
+        while (flush_running && !front) pthread_cond_wait(&flush_cv, &flush_mu);
+        if (!front) break; // 종료 요청
+        const uint8_t* buf = front;
+        pthread_mutex_unlock(&flush_mu);
+
+        uint64_t us = panel_flush(buf, &front_dirty);
+
+        pthread_mutex_lock(&flush_mu);
+        note_flush(us);
+        front = NULL;
+        inflight = 0;
+        pthread_cond_broadcast(&flush_cv);
     }
+    pthread_mutex_unlock(&flush_mu);
+    return NULL;
+}
+
+static void wait_idle(void) { // 전송 중인 프레임이 끝날 때까지 대기
+    pthread_mutex_lock(&flush_mu);
+    while (inflight) pthread_cond_wait(&flush_cv, &flush_mu);
+    pthread_mutex_unlock(&flush_mu);
+}
+
+static void submit(void) { // 쌓인 영역을 전송 스레드로 넘기고 버퍼 교체 - 전송 중이면 다음 프레임으로 미룸
+    if (dirty.n == 0) return;
+
+    if (!threaded) { // 스레드 없이 바로 전송
+        for (int i = 0; i < dirty.n; i++) mirror_update(&dirty.r[i]);
+        framecap_frame(fb, FB_STRIDE, &dirty);
+        note_flush(panel_flush(fb, &dirty));
+        dirty_clear(&dirty);
+        return;
+    }
+
+    pthread_mutex_lock(&flush_mu);
+    if (inflight) { // 아직 이전 프레임 전송 중 - 이번 프레임은 다음에 합쳐서 보냄
+        rstats.frames_dropped++;
+        pthread_mutex_unlock(&flush_mu);
+        return;
+    }
+    for (int i = 0; i < dirty.n; i++) mirror_update(&dirty.r[i]); // 미러는 TFT로 넘긴 프레임을 보여줌
+    uint8_t* done = fb;
+    front = done;
+    front_dirty = dirty;
+    inflight = 1;
+    pthread_cond_signal(&flush_cv);
+    pthread_mutex_unlock(&flush_mu);
+
+    // 새 뒤 버퍼는 방금 넘긴 변경분이 빠져 있으므로 그 영역만 복사해서 맞춤
+    fb = (done == fbs[0]) ? fbs[1] : fbs[0];
+    for (int i = 0; i < front_dirty.n; i++) {
+        Rect r = align_even(&front_dirty.r[i]);
+        for (int yy = r.y; yy < r.y + r.h; yy++) {
+            int off = yy * FB_STRIDE + r.x / 2;
+            memcpy(&fb[off], &done[off], (size_t)r.w / 2);
+        }
+    }
+    framecap_frame(done, FB_STRIDE, &dirty); // 전송 스레드도 done을 읽기만 함
+    dirty_clear(&dirty);
+}
+
+int render_alloc(void) {
+    size_t fb_bytes = (size_t)FB_STRIDE * ST7789_TFTHEIGHT, enc_bytes = (size_t)ST7789_TFTWIDTH * ST7789_TFTHEIGHT * 2;
+    if (!arena_init(&mem, 3 * arena_round(fb_bytes) + arena_round(enc_bytes))) return 0;
+    fbs[0] = arena_alloc(&mem, fb_bytes);
+    fbs[1] = arena_alloc(&mem, fb_bytes);
+    scratch = arena_alloc(&mem, fb_bytes);
+    enc = arena_alloc(&mem, enc_bytes);
+    fb = fbs[0];
+    return 1;
 }
 
 int render_init(void) {
+    pal_init(); // SPI는 건드리지 않음 - 패널 초기화(st7789_init)와 동시에 불러도 됨
+    flush_running = 1;
+    // 가상 시계(호스트 백엔드)에서는 프레임마다 바로 전송해야 프레임당 SPI 측정이 의미 있음
+    if (hal_realtime()) threaded = pthread_create(&flusher, NULL, flusher_main, NULL) == 0; // 실패하면 동기 전송
     if (!mirror_init()) return 0;
     return 1;
 }
 
 void render_quit(void) {
+    if (threaded) {
+        wait_idle();
+        submit(); // 남은 변경분 마지막으로 전송
+        wait_idle();
+        pthread_mutex_lock(&flush_mu);
+        flush_running = 0;
+        pthread_cond_broadcast(&flush_cv);
+        pthread_mutex_unlock(&flush_mu);
+        pthread_join(flusher, NULL);
+        threaded = 0;
+    }
     mirror_quit();
 }
 
 int render_present(void) { // 1이면 계속, 0이면 종료 요청
+    frames++;
+
+#ifndef NO_SDL
     SDL_Event e;
     while (SDL_PollEvent(&e)) { // q 또는 ESC 누르면 종료
         if (e.type == SDL_QUIT) return 0;
@@ -82,26 +290,167 @@ int render_present(void) { // 1이면 계속, 0이면 종료 요청
             SDL_Keycode k = e.key.keysym.sym;
             if (k == SDLK_q || k == SDLK_ESCAPE) return 0;
         }
+        if (e.type == SDL_WINDOWEVENT) mirror_stale = 1; // 가려졌다 보이는 등 - 다시 표시
     }
-    SDL_UpdateTexture(tex, NULL, mirror_rgba, ST7789_TFTWIDTH * sizeof(uint32_t));
-    SDL_RenderClear(ren);
-    SDL_RenderCopy(ren, tex, NULL, NULL);
-    SDL_RenderPresent(ren);
+#endif
+
+    submit(); // 프레임마다 한 번만 전송 스레드로 넘김 (미러 텍스처도 이때 갱신)
+    mirror_present(); // 아무것도 안 바뀐 프레임은 표시 생략
+    return 1;
+}
+
+int render_mirror_open(void) {
+#ifndef NO_SDL
+    return win != NULL;
+#else
+    return 0;
+#endif
+}
+
+void render_invalidate(void) {
+    mark(0, 0, ST7789_TFTWIDTH, ST7789_TFTHEIGHT);
+}
+
+void render_wait(void) {
+    if (threaded) wait_idle();
+}
+
+uint32_t render_frames(void) {
+    return frames;
+}
+
+RenderStats render_stats(void) {
+    pthread_mutex_lock(&flush_mu);
+    RenderStats s = rstats;
+    pthread_mutex_unlock(&flush_mu);
+    return s;
+}
+
+void render_report(void) {
+    RenderStats s = render_stats();
+    printf("render: flushed %u, dropped %u, flush last %llu us, max %llu us, mean %llu us, kernels %s\n",
+           s.frames_flushed, s.frames_dropped, (unsigned long long)s.flush_last_us,
+           (unsigned long long)s.flush_max_us,
+           (unsigned long long)(s.frames_flushed ? s.flush_total_us / s.frames_flushed : 0), px_impl());
+}
+
+void render_snapshot(uint16_t* out) {
+    for (int y = 0; y < ST7789_TFTHEIGHT; y++) {
+        pal_expand_565(&out[y * ST7789_TFTWIDTH], &fb[y * FB_STRIDE], FB_STRIDE);
+    }
+    if (PANEL_BPP == 12) { // 12비트 모드에서 패널에 실제로 보이는 색
+        for (int i = 0; i < ST7789_TFTWIDTH * ST7789_TFTHEIGHT; i++) out[i] = pal_quantize444(out[i]);
+    }
+}
+
+void render_capture_begin(void) {
+    if (screen_fb) return;
+    screen_fb = fb;
+    fb = scratch;
+}
 
+int render_capture_end(RleImage* out) {
+    if (!screen_fb) return 0;
+
+    uint32_t n = 0;
+    uint32_t* row_off = malloc((ST7789_TFTHEIGHT + 1u) * sizeof(uint32_t));
+    for (int y = 0; row_off && y < ST7789_TFTHEIGHT; y++) { // 줄마다 [길이, 인덱스] 쌍 - run은 줄을 넘지 않음
+        const uint8_t* row = &fb[y * FB_STRIDE];
+        row_off[y] = n;
+        int x = 0;
+        while (x < ST7789_TFTWIDTH) {
+            uint8_t idx = fb_get(row, x);
+            int len = 1;
+            while (x + len < ST7789_TFTWIDTH && len < 255 && fb_get(row, x + len) == idx) len++;
+            enc[n++] = (uint8_t)len;
+            enc[n++] = idx;
+            x += len;
+        }
+    }
+
+    fb = screen_fb; // 원래 프레임버퍼로 복귀 - 실패해도
+    screen_fb = NULL;
+
+    uint8_t* data = row_off ? malloc(n) : NULL;
+    if (!data) {
+        free(row_off);
+        return 0;
+    }
+    row_off[ST7789_TFTHEIGHT] = n;
+    memcpy(data, enc, n);
+    out->row_off = row_off;
+    out->data = data;
     return 1;
 }
 
+void render_blit_rle(const RleImage* img) {
+    for (int y = 0; y < ST7789_TFTHEIGHT; y++) {
+        uint8_t* row = &fb[y * FB_STRIDE];
+        int x = 0, span = -1; // span: 현재 바뀌고 있는 구간의 시작
+        for (uint32_t i = img->row_off[y]; i < img->row_off[y + 1]; i += 2) {
+            int len = img->data[i];
+            uint8_t idx = img->data[i + 1];
+            for (int k = 0; k < len; k++, x++) {
+                if (fb_get(row, x) != idx) {
+                    fb_put(row, x, idx);
+                    if (span < 0) span = x;
+                } else if (span >= 0) { // 바뀐 구간 끝 - 그 구간만 기록
+                    mark(span, y, x - span, 1);
+                    span = -1;
+                }
+            }
+        }
+        if (span >= 0) mark(span, y, x - span, 1);
+    }
+}
+
 void fill_screen_both(uint16_t color) {
-    st7789_fillScreen(color);
-    mirror_fillScreen(color);
+    fb_fillRect(0, 0, ST7789_TFTWIDTH, ST7789_TFTHEIGHT, color);
 }
 
 void draw_rect_both(int x, int y, int w, int h, uint16_t color) {
-    st7789_fillRect((uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h, color);
-    mirror_fillRect(x, y, w, h, color);
+    if (x < 0 || y < 0 || x >= ST7789_TFTWIDTH || y >= ST7789_TFTHEIGHT) return; // 범위 밖이면 무시
+    if (x + w > ST7789_TFTWIDTH)  w = ST7789_TFTWIDTH - x;
+    if (y + h > ST7789_TFTHEIGHT) h = ST7789_TFTHEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    fb_fillRect(x, y, w, h, color);
+}
+
+void blit_both(int x, int y, int w, int h, const uint16_t* px) {
+    int stride = w;
+    if (x < 0) { px -= x; w += x; x = 0; } // 왼쪽/위쪽 잘라내기
+    if (y < 0) { px -= y * stride; h += y; y = 0; }
+    if (x + w > ST7789_TFTWIDTH)  w = ST7789_TFTWIDTH - x;
+    if (y + h > ST7789_TFTHEIGHT) h = ST7789_TFTHEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    for (int yy = 0; yy < h; yy++) {
+        const uint16_t* src = px + yy * stride;
+        uint8_t* row = &fb[(y + yy) * FB_STRIDE];
+        for (int xx = 0; xx < w; xx++) fb_put(row, x + xx, pal_index(src[xx]));
+    }
+    mark(x, y, w, h);
+}
+
+void blit_packed(int x, int y, int w, int h, const uint8_t* src, int stride) {
+    if (x < 0 || y < 0 || x + w > ST7789_TFTWIDTH || y + h > ST7789_TFTHEIGHT || w <= 0 || h <= 0) return;
+
+    for (int yy = 0; yy < h; yy++, src += stride) {
+        uint8_t* row = &fb[(y + yy) * FB_STRIDE];
+        if (!(x & 1) && !(w & 1)) { // 바이트 경계가 맞으면 줄 단위 복사 (셀 타일은 항상 이 경우)
+            memcpy(&row[x >> 1], src, (size_t)w >> 1);
+            continue;
+        }
+        for (int xx = 0; xx < w; xx++) {
+            uint8_t b = src[xx >> 1];
+            fb_put(row, x + xx, (xx & 1) ? (b & 0x0F) : (b >> 4));
+        }
+    }
+    mark(x, y, w, h);
 }
 
-void draw_cell(uint8_t gx, uint8_t gy, uint16_t color) {
+void draw_cell(uint16_t gx, uint16_t gy, uint16_t color) {
     int px = gx * CELL; // 격자 좌표를 픽셀 좌표로 변환
     int py = gy * CELL;
     draw_rect_both(px, py, CELL, CELL, color);
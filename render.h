@@ -2,11 +2,43 @@
 
 #include <stdint.h>
 
-int render_init(void); // SDL 미러 렌더러 초기화
-void render_quit(void); // 렌더러 종료
-int render_present(void);   // 1이면 계속, 0이면 종료 요청
+#include "st7789.h"
 
+typedef struct {
+    uint32_t frames_flushed; // TFT로 보낸 프레임 수
+    uint32_t frames_dropped; // 전송 스레드가 바빠서 다음 프레임에 합친 수 - 많으면 SPI가 병목
+    uint64_t flush_last_us;  // 프레임 하나 전송 시간
+    uint64_t flush_max_us;
+    uint64_t flush_total_us;
+    uint32_t spi_bytes;      // 지금까지 TFT로 보낸 바이트 (st7789_stats를 전송 쪽에서 옮겨 둔 값)
+    uint32_t spi_windows;
+} RenderStats;
+
+// 미리 만들어 둔 화면 이미지: 줄마다 [길이, 팔레트 인덱스] 쌍으로 run-length 압축
+typedef struct {
+    uint8_t* data;
+    uint32_t* row_off; // [ST7789_TFTHEIGHT + 1] 줄 y의 run은 data[row_off[y] .. row_off[y+1])
+} RleImage;
+
+int render_alloc(void); // 프레임버퍼 등 패널 크기 버퍼를 한 번에 받음 - st7789_setGeometry 다음, render_init 전. 실패하면 0
+int render_init(void); // TFT 전송 스레드 시작, SDL 미러 렌더러 초기화 (TFT로는 아무것도 안 보냄)
+void render_quit(void); // 남은 프레임 전송 후 렌더러 종료
+int render_present(void);   // 바뀐 영역을 TFT로 전송하고 미러 갱신. 1이면 계속, 0이면 종료 요청
+int render_mirror_open(void); // SDL 미러 창이 떠 있음 - 창 이벤트는 기다릴 fd가 없어서 render_present로 주기적으로 확인해야 함
+void render_invalidate(void); // 다음 프레임에 화면 전체를 보냄 - 패널 RAM 내용을 모를 때 (리셋 직후, 이전 실행의 화면)
+void render_wait(void); // 넘겨준 프레임이 TFT로 다 전송될 때까지 대기
+uint32_t render_frames(void); // 지금까지 표시한 프레임 수
+RenderStats render_stats(void); // 전송 스레드 통계
+void render_report(void); // 전송 통계 출력
+void render_snapshot(uint16_t* out); // 패널에 보여야 할 화면을 RGB565로 (ST7789_TFTWIDTH * ST7789_TFTHEIGHT)
+void render_capture_begin(void); // 이후 그리기를 화면 밖 버퍼에 함
+int render_capture_end(RleImage* out); // 화면 밖 버퍼를 RLE로 압축해 out에 저장하고 원래 화면으로 복귀
+void render_blit_rle(const RleImage* img); // 지금 화면과 비교해서 다른 구간만 그림
+
+// 아래 그리기 함수는 프레임버퍼에만 쓰고, 실제 TFT 전송은 render_present에서 한 번에 함
 void fill_screen_both(uint16_t color); // 화면 전체를 color로 채움 TFT/미러링 둘다
 void draw_rect_both(int x, int y, int w, int h, uint16_t color); // 사각형 그리기 TFT/미러링 둘다
-void draw_cell(uint8_t gx, uint8_t gy, uint16_t color); // 격자 좌표에 셀 그리기
+void blit_both(int x, int y, int w, int h, const uint16_t* px); // w*h RGB565 픽셀 블록 그리기
+void blit_packed(int x, int y, int w, int h, const uint8_t* src, int stride); // 이미 4비트 인덱스로 패킹된 블록 복사 (stride: 줄당 바이트)
+void draw_cell(uint16_t gx, uint16_t gy, uint16_t color); // 격자 좌표에 셀 그리기
 void dot(int x, int y, int s, uint16_t color); // 점 그리기
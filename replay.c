@@ -0,0 +1,133 @@
+#include "replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_VERSION 1
+
+static FILE* rec = NULL; // 기록 중인 파일
+static uint32_t rec_tick = 0; // 마지막으로 기록한 이벤트의 틱
+static uint32_t rec_n = 0;
+
+static uint8_t* play = NULL; // 재생 파일 내용
+static size_t play_len = 0, play_pos = 0;
+static uint32_t play_tick = 0; // 다음 이벤트의 틱 (play_pos가 키 바이트를 가리킬 때)
+static uint32_t end_tick = UINT32_MAX; // 끝 표시를 읽기 전까지는 모름
+static int end_score = -1;
+
+static void put_var(FILE* f, uint32_t v) { // LEB128 - 7비트씩, 대부분 1바이트
+    do {
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        fputc(v ? (b | 0x80) : b, f);
+    } while (v);
+}
+
+static int get_var(uint32_t* v) {
+    *v = 0;
+    for (int sh = 0; sh < 35 && play_pos < play_len; sh += 7) {
+        uint8_t b = play[play_pos++];
+        *v |= (uint32_t)(b & 0x7F) << sh;
+        if (!(b & 0x80)) return 1;
+    }
+    return 0;
+}
+
+int replay_record_open(const char* path, uint64_t seed) {
+    rec = fopen(path, "wb");
+    if (!rec) {
+        perror(path);
+        return 0;
+    }
+    fwrite("SNKR", 1, 4, rec);
+    fputc(REPLAY_VERSION, rec);
+    for (int i = 0; i < 8; i++) fputc((int)((seed >> (8 * i)) & 0xFF), rec);
+    rec_tick = 0;
+    rec_n = 0;
+    return 1;
+}
+
+void replay_record(uint32_t tick, uint8_t key) {
+    if (!rec) return;
+    put_var(rec, tick - rec_tick);
+    fputc(key, rec);
+    rec_tick = tick;
+    rec_n++;
+}
+
+void replay_record_close(uint32_t tick, int score) {
+    if (!rec) return;
+    put_var(rec, tick - rec_tick);
+    fputc(REPLAY_END, rec);
+    put_var(rec, (uint32_t)score);
+    fclose(rec);
+    rec = NULL;
+    printf("record: %u events, %u ticks\n", rec_n, tick);
+}
+
+static void read_tick(void) { // 다음 이벤트의 틱 차이를 읽어 둠 - 끝 표시면 끝 정보까지 읽음
+    uint32_t d = 0;
+    if (!get_var(&d) || play_pos >= play_len) { // 잘린 파일 - 지금까지만 재생
+        end_tick = play_tick;
+        play_pos = play_len;
+        return;
+    }
+    play_tick += d;
+    if (play[play_pos] == REPLAY_END) {
+        uint32_t s = 0;
+        play_pos++;
+        end_tick = play_tick;
+        if (get_var(&s)) end_score = (int)s;
+        play_pos = play_len;
+    }
+}
+
+int replay_open(const char* path, uint64_t* seed) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    play = n > 0 ? malloc((size_t)n) : NULL;
+    if (!play || fread(play, 1, (size_t)n, f) != (size_t)n || n < 13 ||
+        memcmp(play, "SNKR", 4) != 0 || play[4] != REPLAY_VERSION) {
+        printf("%s: not a replay file\n", path);
+        fclose(f);
+        replay_close();
+        return 0;
+    }
+    fclose(f);
+
+    *seed = 0;
+    for (int i = 0; i < 8; i++) *seed |= (uint64_t)play[5 + i] << (8 * i);
+    play_len = (size_t)n;
+    play_pos = 13;
+    play_tick = 0;
+    end_tick = UINT32_MAX;
+    end_score = -1;
+    read_tick();
+    return 1;
+}
+
+int replay_next(uint32_t tick, uint8_t* key) {
+    if (play_pos >= play_len || play_tick > tick) return 0;
+    *key = play[play_pos++];
+    read_tick();
+    return 1;
+}
+
+int replay_pending(void) { return play_pos < play_len; }
+
+uint32_t replay_end_tick(void) { return end_tick; }
+
+int replay_end_score(void) { return end_score; }
+
+void replay_close(void) {
+    free(play);
+    play = NULL;
+    play_len = play_pos = 0;
+}
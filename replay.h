@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// 입력 기록/재생 - 시드와 "몇 번째 틱 전에 어떤 버튼이 눌렸는지"만 저장
+// 파일 형식 (리틀 엔디언):
+//   "SNKR" 버전(1바이트) 시드(8바이트)
+//   이벤트: 이전 이벤트와의 틱 차이(LEB128 가변 길이) + 키(1바이트)
+//   끝: 틱 차이 + REPLAY_END + 마지막 점수(LEB128)
+// 같은 시드 + 같은 틱에 같은 입력이면 게임 진행이 똑같으므로, 긴 게임을 빌드끼리 성능 비교용으로 재생할 수 있음
+
+#define REPLAY_END 0xFF
+
+int replay_record_open(const char* path, uint64_t seed); // 기록 시작
+void replay_record(uint32_t tick, uint8_t key); // 눌림 이벤트 하나 기록 - 기록 중이 아니면 무시
+void replay_record_close(uint32_t tick, int score); // 끝 표시를 쓰고 닫음
+
+int replay_open(const char* path, uint64_t* seed); // 재생 파일 전체를 읽음
+int replay_next(uint32_t tick, uint8_t* key); // 틱 tick 전까지 처리할 다음 이벤트가 있으면 1
+int replay_pending(void); // 아직 안 꺼낸 이벤트가 있는지
+uint32_t replay_end_tick(void); // 기록을 끝낸 틱
+int replay_end_score(void); // 기록을 끝낼 때 점수 (재생 결과 확인용)
+void replay_close(void);
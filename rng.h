@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+// PCG32 난수 생성기 - 시드가 같으면 어느 빌드/플랫폼에서나 같은 수열 (rand()는 libc마다 다름)
+
+typedef struct { uint64_t state; } Rng;
+
+#define RNG_INC 1442695040888963407ULL // 수열 선택 상수 (홀수)
+
+static inline uint32_t rng_next(Rng* r) {
+    uint64_t old = r->state;
+    r->state = old * 6364136223846793005ULL + RNG_INC;
+    uint32_t x = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (x >> rot) | (x << ((-rot) & 31));
+}
+
+static inline void rng_seed(Rng* r, uint64_t seed) {
+    r->state = 0;
+    rng_next(r);
+    r->state += seed;
+    rng_next(r);
+}
+
+static inline uint32_t rng_below(Rng* r, uint32_t n) { // [0, n) - 곱셈으로 범위 줄이기 (나눗셈 없음)
+    return (uint32_t)(((uint64_t)rng_next(r) * n) >> 32);
+}
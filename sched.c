@@ -0,0 +1,60 @@
+#include "sched.h"
+
+#include <stdio.h>
+
+#include "hal.h"
+
+void sched_start(Sched* s, uint32_t period_ms) {
+    s->period_us = (uint64_t)period_ms * 1000u;
+    s->ticks = 0;
+    s->dropped = 0;
+    s->late_last_us = 0;
+    s->late_max_us = 0;
+    s->late_sum_us = 0;
+    sched_resync(s);
+}
+
+void sched_set_period(Sched* s, uint32_t period_ms) {
+    uint64_t p = (uint64_t)period_ms * 1000u;
+    if (p == s->period_us) return;
+    s->next_us = s->next_us - s->period_us + p; // 이미 잡힌 마감도 새 주기로 다시 계산
+    s->period_us = p;
+}
+
+void sched_resync(Sched* s) {
+    s->next_us = hal_now_us() + s->period_us;
+}
+
+int sched_due(Sched* s) {
+    uint64_t now = hal_now_us();
+    if (now < s->next_us) return 0;
+
+    uint64_t n = (now - s->next_us) / s->period_us + 1; // 지나간 마감 개수
+    if (n > SCHED_MAX_CATCHUP) { // 너무 밀렸으면 오래된 마감은 버림
+        s->dropped += (uint32_t)(n - SCHED_MAX_CATCHUP);
+        s->next_us += (n - SCHED_MAX_CATCHUP) * s->period_us;
+        n = SCHED_MAX_CATCHUP;
+    }
+
+    for (uint64_t i = 0; i < n; i++) { // 실행할 틱마다 지연 기록
+        uint64_t late = now - s->next_us;
+        s->late_last_us = late;
+        if (late > s->late_max_us) s->late_max_us = late;
+        s->late_sum_us += late;
+        s->next_us += s->period_us;
+        s->ticks++;
+    }
+    return (int)n;
+}
+
+void sched_wait(const Sched* s, uint32_t max_wait_ms) {
+    uint64_t limit = hal_now_us() + (uint64_t)max_wait_ms * 1000u;
+    hal_sleep_until_us(s->next_us < limit ? s->next_us : limit);
+}
+
+void sched_report(const Sched* s) {
+    printf("sched: period %llu us, ticks %u, dropped %u, late last %llu us, max %llu us, mean %llu us\n",
+           (unsigned long long)s->period_us, s->ticks, s->dropped,
+           (unsigned long long)s->late_last_us, (unsigned long long)s->late_max_us,
+           (unsigned long long)(s->ticks ? s->late_sum_us / s->ticks : 0));
+}
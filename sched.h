@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+// 고정 주기 틱 스케줄러 - 단조 시계의 절대 마감 시각 기준
+// 렌더링/입력 처리 시간과 상관없이 period마다 한 틱씩 진행하고,
+// 늦으면 최대 SCHED_MAX_CATCHUP 틱까지 몰아서 따라잡고 나머지는 버림
+
+#define SCHED_MAX_CATCHUP 3
+
+typedef struct {
+    uint64_t period_us;   // 틱 주기
+    uint64_t next_us;     // 다음 틱 마감 시각(절대)
+    uint32_t ticks;       // 실행한 틱 수
+    uint32_t dropped;     // 따라잡기 한도를 넘어 버린 틱 수
+    uint64_t late_last_us; // 마지막 틱이 마감보다 늦은 시간
+    uint64_t late_max_us;
+    uint64_t late_sum_us;
+} Sched;
+
+void sched_start(Sched* s, uint32_t period_ms); // 지금부터 period_ms마다 틱
+void sched_set_period(Sched* s, uint32_t period_ms); // 주기 변경 (다음 마감부터 적용)
+void sched_resync(Sched* s); // 멈춰 있던 뒤 다시 시작할 때: 다음 마감을 지금 + 주기로
+int sched_due(Sched* s); // 지금 실행해야 할 틱 수 (0..SCHED_MAX_CATCHUP)
+void sched_wait(const Sched* s, uint32_t max_wait_ms); // 다음 마감까지(최대 max_wait_ms) 잠
+void sched_report(const Sched* s); // 틱 지연 통계 출력
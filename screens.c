@@ -0,0 +1,76 @@
+#include "screens.h"
+
+#include "config.h"
+#include "font5x7.h"
+#include "render.h"
+
+static RleImage images[SCREEN_COUNT];
+
+static void compose_menu(void) { // 메뉴 화면
+    fill_screen_both(C_BLUE); // 배경을 파란색으로 채움
+
+    int sdot = 4;
+    int line_h = 7 * sdot + 6;
+    int start_y = (ST7789_TFTHEIGHT - line_h * 2) / 2;
+
+    draw_text_line_px("SNAKE", start_y, sdot, C_WHITE, C_BLUE);
+    draw_text_line_px("START", start_y + line_h, sdot, C_WHITE, C_BLUE);
+}
+
+static void compose_gameover(void) { // 게임 오버 화면
+    fill_screen_both(C_RED); // 배경을 빨간색으로 채움
+
+    int sdot = 4;
+    int line_h = 7 * sdot + 6;
+
+    int total_h = line_h * 2;
+    int start_y = (ST7789_TFTHEIGHT - total_h) / 2;
+
+    draw_text_line_px("GAME", start_y, sdot, C_WHITE, C_RED);
+    draw_text_line_px("OVER", start_y + line_h, sdot, C_WHITE, C_RED);
+}
+
+static void compose_clear(void) { // 클리어 화면
+    fill_screen_both(C_GREEN); // 배경을 초록색으로 채움
+
+    int sdot = 4; // 문자 크기
+    int start_y = (ST7789_TFTHEIGHT - 7 * sdot) / 2;
+
+    draw_text_line_px("CLEAR!", start_y, sdot, C_WHITE, C_GREEN); // 중앙에 "CLEAR!" 텍스트 그리기
+}
+
+static void compose_two_lines(const char* a, const char* b, uint16_t bg) { // 가운데 두 줄 - 대전 결과
+    fill_screen_both(bg);
+
+    int sdot = 4;
+    int line_h = 7 * sdot + 6;
+    int start_y = (ST7789_TFTHEIGHT - line_h * 2) / 2;
+
+    draw_text_line_px(a, start_y, sdot, C_WHITE, bg);
+    draw_text_line_px(b, start_y + line_h, sdot, C_WHITE, bg);
+}
+
+static void compose_win(void) { compose_two_lines("YOU", "WIN", C_GREEN); }
+
+static void compose_draw(void) { compose_two_lines("DRAW", "GAME", C_BLUE); }
+
+static void (*const compose[SCREEN_COUNT])(void) = {
+    [SCREEN_MENU] = compose_menu,
+    [SCREEN_GAMEOVER] = compose_gameover,
+    [SCREEN_CLEAR] = compose_clear,
+    [SCREEN_WIN] = compose_win,
+    [SCREEN_DRAW] = compose_draw,
+};
+
+int screens_init(void) {
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        render_capture_begin();
+        compose[i]();
+        if (!render_capture_end(&images[i])) return 0;
+    }
+    return 1;
+}
+
+void screen_show(ScreenId id) {
+    render_blit_rle(&images[id]);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// 메뉴/게임 오버/클리어 같은 전체 화면
+// 시작할 때 한 번 화면 밖에 그려서 RLE로 압축해 두고, 전환할 때는 지금 화면과 다른 구간만 그림
+
+typedef enum {
+    SCREEN_MENU,
+    SCREEN_GAMEOVER,
+    SCREEN_CLEAR,
+    SCREEN_WIN,  // 대전 모드 결과 (지면 SCREEN_GAMEOVER)
+    SCREEN_DRAW,
+    SCREEN_COUNT
+} ScreenId;
+
+int screens_init(void); // 모든 화면을 미리 그려 둠 - render_init 다음에 호출
+void screen_show(ScreenId id); // 화면 전환 - 실제 전송은 render_present에서
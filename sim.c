@@ -0,0 +1,201 @@
+#include "sim.h"
+
+#include <string.h>
+
+int grid_cell = CELL_DEFAULT, grid_w = 240 / CELL_DEFAULT, grid_h = 240 / CELL_DEFAULT;
+
+int grid_setup(int w, int h, int cell) {
+    if (cell < CELL_MIN || cell > CELL_MAX || (cell & 1)) return 0;
+    if (w < GRID_MIN || h < GRID_MIN || w > GRID_MAX || h > GRID_MAX) return 0;
+    grid_cell = cell;
+    grid_w = w;
+    grid_h = h;
+    return 1;
+}
+
+static inline int eq(Point a, Point b) { return a.x == b.x && a.y == b.y; } // 두 점이 같은지 확인
+
+static inline int cell_of(Point p) { return p.y * GRID_W + p.x; } // 빈 칸 집합 인덱스
+
+static void emit(GameEvents* ev, GameEventType type, Point p, TileId tile, uint64_t t_us) {
+    if (!ev || ev->n >= GAME_EVENTS_MAX) return;
+    ev->e[ev->n++] = (GameEvent){ (uint8_t)type, (uint8_t)tile, p, t_us };
+}
+
+void free_set_add(FreeSet* f, int c) { // 칸을 빈 칸 집합에 추가
+    if (f->pos[c] >= 0) return;
+    f->pos[c] = (int16_t)f->n;
+    f->cells[f->n++] = (uint16_t)c;
+}
+
+void free_set_remove(FreeSet* f, int c) { // 칸을 빈 칸 집합에서 제거 - 마지막 항목을 그 자리로 옮김
+    int i = f->pos[c];
+    if (i < 0) return;
+    uint16_t last = f->cells[--f->n];
+    f->cells[i] = last;
+    f->pos[last] = (int16_t)i;
+    f->pos[c] = -1;
+}
+
+size_t free_set_bytes(void) {
+    return arena_round(SNAKE_CAP * sizeof(uint16_t)) + arena_round(SNAKE_CAP * sizeof(int16_t));
+}
+
+int free_set_alloc(FreeSet* f, Arena* a) {
+    f->cells = arena_alloc(a, SNAKE_CAP * sizeof(uint16_t));
+    f->pos = arena_alloc(a, SNAKE_CAP * sizeof(int16_t));
+    f->n = 0;
+    return f->cells && f->pos;
+}
+
+void free_set_reset(FreeSet* f) {
+    f->n = 0;
+    for (int c = 0; c < SNAKE_CAP; c++) f->pos[c] = -1;
+    for (int c = HUD_ROWS * GRID_W; c < SNAKE_CAP; c++) free_set_add(f, c);
+}
+
+static void snake_push_head(GameState* g, Point p) { // 머리 앞에 한 칸 추가
+    g->snake_head = (g->snake_head + SNAKE_CAP - 1) % SNAKE_CAP;
+    g->snake[g->snake_head] = p;
+    g->snake_len++;
+    occ_set(g->occ, p);
+    free_set_remove(&g->free, cell_of(p));
+}
+
+static Point snake_pop_tail(GameState* g) { // 꼬리 한 칸 제거
+    Point t = game_snake_at(g, g->snake_len - 1);
+    g->snake_len--;
+    occ_clr(g->occ, t);
+    free_set_add(&g->free, cell_of(t));
+    return t;
+}
+
+static void emit_snake_cell(GameState* g, GameEvents* ev, int i) { // 뱀 i번째 칸 - 머리/몸통/꼬리 타일
+    static const TileId heads[] = {
+        [DIR_UP] = TILE_HEAD_UP, [DIR_DOWN] = TILE_HEAD_DOWN,
+        [DIR_LEFT] = TILE_HEAD_LEFT, [DIR_RIGHT] = TILE_HEAD_RIGHT,
+    };
+    TileId t = i == 0 ? heads[g->dir] : i == g->snake_len - 1 ? TILE_TAIL : TILE_BODY;
+    emit(ev, EV_CELL, game_snake_at(g, i), t, 0);
+}
+
+static int spawn_food_at(GameState* g, GameEvents* ev, int idx) { // 음식 생성 - 빈 칸 집합에서 뽑으므로 뱀/다른 음식과 안 겹침
+    if (g->free.n == 0) { // 빈 칸이 없으면 슬롯을 비워 두고, 나중 틱에 칸이 비면 다시 채움
+        g->foods[idx] = FOOD_NONE;
+        return 0;
+    }
+    int c = g->free.cells[rng_below(&g->rng, (uint32_t)g->free.n)];
+    free_set_remove(&g->free, c);
+    Point p = { (uint16_t)(c % GRID_W), (uint16_t)(c / GRID_W) }; // HUD_ROWS(점수벽) 이후 영역만 들어 있음
+    g->foods[idx] = p;
+    emit(ev, EV_CELL, p, TILE_FOOD, 0);
+    return 1;
+}
+
+size_t game_state_bytes(void) {
+    return arena_round(SNAKE_CAP * sizeof(Point)) + arena_round((size_t)GRID_H * OCC_WORDS * sizeof(uint64_t)) +
+           free_set_bytes();
+}
+
+int game_state_alloc(GameState* g, Arena* a) {
+    memset(g, 0, sizeof(*g));
+    g->snake = arena_alloc(a, SNAKE_CAP * sizeof(Point));
+    g->occ = arena_alloc(a, (size_t)GRID_H * OCC_WORDS * sizeof(uint64_t));
+    return g->snake && g->occ && free_set_alloc(&g->free, a);
+}
+
+void game_state_init(GameState* g, uint64_t seed) { // 배열 포인터는 그대로 두고 나머지만 초기화
+    g->snake_head = g->snake_len = 0;
+    g->dir = DIR_RIGHT;
+    for (int i = 0; i < FOOD_COUNT; i++) g->foods[i] = FOOD_NONE;
+    g->turn_n = 0;
+    g->score = 0;
+    g->steps = 0;
+    rng_seed(&g->rng, seed);
+    g->status = GAME_DEAD; // game_reset 전까지는 진행 안 함
+}
+
+void game_reset(GameState* g, GameEvents* ev) {
+    g->score = 0;
+    g->steps = 0;
+    g->status = GAME_RUNNING;
+    g->snake_len = 0;
+    g->snake_head = 0;
+    memset(g->occ, 0, (size_t)GRID_H * OCC_WORDS * sizeof(uint64_t)); // 판마다 O(격자) - 틱에서는 안 함
+    free_set_reset(&g->free);
+    g->dir = DIR_RIGHT; // 초기 이동 방향
+    g->turn_n = 0;
+
+    uint16_t sy = (uint16_t)(HUD_ROWS + (GRID_H - HUD_ROWS) / 2);
+
+    // 뱀 초기 위치 설정 - 화면 중앙 가로줄 3칸 (꼬리부터 넣음)
+    snake_push_head(g, (Point){ (uint16_t)(GRID_W / 2 - 2), sy });
+    snake_push_head(g, (Point){ (uint16_t)(GRID_W / 2 - 1), sy });
+    snake_push_head(g, (Point){ (uint16_t)(GRID_W / 2), sy });
+    for (int i = 0; i < g->snake_len; i++) emit_snake_cell(g, ev, i);
+
+    for (int i = 0; i < FOOD_COUNT; i++) spawn_food_at(g, ev, i); // 음식 생성
+}
+
+void game_queue_turn(GameState* g, Dir d, uint64_t t_us) {
+    Dir last = g->turn_n ? g->turns[g->turn_n - 1].dir : g->dir; // 마지막으로 예약된(또는 현재) 방향 기준
+    int reverse = (last == DIR_UP && d == DIR_DOWN) || (last == DIR_DOWN && d == DIR_UP) ||
+                  (last == DIR_LEFT && d == DIR_RIGHT) || (last == DIR_RIGHT && d == DIR_LEFT);
+    if (d == DIR_NONE || reverse || last == d || g->turn_n >= TURN_QUEUE) return;
+    g->turns[g->turn_n++] = (Turn){ d, t_us };
+}
+
+GameStatus game_step(GameState* g, const GameInput* in, GameEvents* ev) {
+    if (g->status != GAME_RUNNING) return g->status;
+    if (in) game_queue_turn(g, in->turn, in->t_us);
+
+    g->steps++;
+    if (g->turn_n > 0) { // 예약된 방향 전환을 하나 적용
+        g->dir = g->turns[0].dir;
+        emit(ev, EV_TURN, game_snake_at(g, 0), TILE_EMPTY, g->turns[0].t_us);
+        for (int i = 1; i < g->turn_n; i++) g->turns[i - 1] = g->turns[i];
+        g->turn_n--;
+    }
+    Point nh = game_snake_at(g, 0); // 새로운 머리 위치 계산
+
+    if (g->dir == DIR_UP) nh.y--; // 위로 이동 (0에서 빼면 65535가 되어 벽 검사에 걸림)
+    else if (g->dir == DIR_DOWN) nh.y++;
+    else if (g->dir == DIR_LEFT) nh.x--;
+    else if (g->dir == DIR_RIGHT) nh.x++;
+
+    if (nh.x >= GRID_W || nh.y >= GRID_H || nh.y < HUD_ROWS || game_occupied(g, nh)) { // 벽/자기 몸 충돌
+        return g->status = GAME_DEAD;
+    }
+
+    // 음식 섭취 검사
+    int ate = -1;
+    for (int i = 0; i < FOOD_COUNT; i++) {
+        if (eq(nh, g->foods[i])) {
+            ate = i;
+            break;
+        }
+    }
+
+    if (ate >= 0) { // 점수 증가 및 클리어 검사
+        g->score++;
+        emit(ev, EV_EAT, nh, TILE_EMPTY, 0);
+    }
+    if (g->score >= CLEAR_SCORE) return g->status = GAME_CLEAR;
+
+    // 뱀 이동 처리
+    if (ate < 0) { // 음식 안 먹었으면 꼬리 지우기, 먹었으면 그대로 두어 길이 증가
+        Point tail = snake_pop_tail(g);
+        emit(ev, EV_CELL, tail, TILE_EMPTY, 0);
+    }
+    snake_push_head(g, nh); // 머리 위치 갱신 - 몸통은 움직일 필요 없음
+
+    emit_snake_cell(g, ev, 0); // 새로운 머리
+    emit_snake_cell(g, ev, 1); // 이전 머리는 몸통으로 (길이 2면 꼬리)
+    emit_snake_cell(g, ev, g->snake_len - 1); // 새 꼬리
+
+    if (ate >= 0) spawn_food_at(g, ev, ate); // 새로운 음식 생성
+    for (int i = 0; i < FOOD_COUNT && g->free.n > 0; i++) { // 칸이 없어 비워 둔 슬롯이 있으면 다시 채움
+        if (g->foods[i].x == FOOD_NONE.x) spawn_food_at(g, ev, i);
+    }
+    return GAME_RUNNING;
+}
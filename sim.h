@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "config.h"
+#include "rng.h"
+#include "tiles.h"
+
+// 게임 규칙만 담은 순수 시뮬레이션 - 전역 상태도, 그리기/입출력도 없음
+// 한 프로세스에서 GameState를 여러 개 만들어 동시에 돌릴 수 있음 (batch.c)
+// 화면에 보여야 할 변화는 그리는 대신 GameEvents로 돌려줌 - game.c가 받아서 그림
+// 격자 크기만큼의 배열은 game_state_alloc이 아레나에서 한 번 받아 두고 판마다 다시 씀
+
+#define SNAKE_CAP (GRID_W * GRID_H) // 격자 칸 수 - 24 * 24부터 160 * 120까지
+
+_Static_assert(GRID_MAX * GRID_MAX <= 32767, "FreeSet positions are int16_t");
+#define FOOD_NONE ((Point){ 0xFFFF, 0xFFFF }) // 빈 칸이 없어 음식을 못 놓은 슬롯
+
+typedef struct { uint16_t x, y; } Point; // 격자 좌표 (0에서 빼면 65535가 되어 벽 검사에 걸림)
+typedef enum { DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT, DIR_NONE } Dir; // 이동 방향 (DIR_NONE: 입력 없음)
+
+typedef enum {
+    GAME_RUNNING,
+    GAME_DEAD,  // 벽이나 몸에 부딪힘
+    GAME_CLEAR, // CLEAR_SCORE 달성
+} GameStatus;
+
+typedef struct { Dir dir; uint64_t t_us; } Turn; // 예약된 방향 전환과 입력 엣지 시각
+
+// 빈 칸 집합: 뱀도 음식도 없는 플레이 영역 칸들 - 밀집 배열 + 위치 인덱스(바꿔서 지우기)
+typedef struct {
+    uint16_t* cells; // [SNAKE_CAP]
+    int16_t* pos;    // [SNAKE_CAP] 칸 -> cells 안의 위치, 없으면 -1
+    int n;
+} FreeSet;
+
+typedef struct {
+    // 뱀 몸통: 원형 버퍼 - 이동할 때 배열을 밀지 않고 머리 인덱스만 옮김
+    Point* snake; // [SNAKE_CAP]
+    int snake_head; // 머리가 있는 인덱스, 몸통은 head+1, head+2 ... 순서
+    int snake_len;
+    uint64_t* occ; // 뱀이 차지한 칸 비트보드 - 줄마다 OCC_WORDS개, 비트 x = 열 x
+    Dir dir;
+    Point foods[FOOD_COUNT]; // 음식마다의 좌표 (빈 슬롯은 FOOD_NONE)
+
+    FreeSet free; // 음식은 여기서 뽑음
+
+    Turn turns[TURN_QUEUE]; // 틱마다 하나씩 적용할 방향 전환
+    int turn_n;
+
+    int score;
+    uint32_t steps; // 이번 판에서 진행한 틱 수
+    GameStatus status;
+    Rng rng; // 먹이 위치 - 판이 바뀌어도 이어서 씀 (시드 하나로 여러 판 재현)
+} GameState;
+
+// 이벤트: 바뀐 칸과 그 칸에 그릴 타일
+typedef enum {
+    EV_CELL,  // (p, tile) 칸을 다시 그림
+    EV_TURN,  // 예약된 방향 전환 적용 (t_us: 입력 엣지 시각) - 지연 측정용
+    EV_EAT,   // 먹이를 먹음 (점수 바뀜)
+} GameEventType;
+
+typedef struct {
+    uint8_t type; // GameEventType
+    uint8_t tile; // EV_CELL: TileId
+    Point p;
+    uint64_t t_us;
+} GameEvent;
+
+#define GAME_EVENTS_MAX (8 + 2 * FOOD_COUNT) // 한 번의 game_reset / game_step이 낼 수 있는 최대 개수
+
+typedef struct {
+    GameEvent e[GAME_EVENTS_MAX];
+    int n;
+} GameEvents;
+
+typedef struct {
+    Dir turn;     // 이번 틱 전에 들어온 방향 입력 (없으면 DIR_NONE)
+    uint64_t t_us; // 입력 엣지 시각
+} GameInput;
+
+size_t free_set_bytes(void); // free_set_alloc이 아레나에서 받는 크기
+int free_set_alloc(FreeSet* f, Arena* a);
+void free_set_reset(FreeSet* f); // 플레이 영역(HUD 줄 아래) 전체를 빈 칸으로
+void free_set_add(FreeSet* f, int c); // c = y * GRID_W + x
+void free_set_remove(FreeSet* f, int c);
+
+size_t game_state_bytes(void); // 지금 격자에서 GameState 하나가 아레나에서 받는 크기
+int game_state_alloc(GameState* g, Arena* a); // 격자 크기 배열 받기 - GameState마다 한 번. 모자라면 0
+void game_state_init(GameState* g, uint64_t seed); // 난수 시드 설정 - 판은 game_reset으로 시작 (배열은 그대로 씀)
+void game_reset(GameState* g, GameEvents* ev); // 새 판: 뱀/먹이 배치, 그릴 칸을 ev에 (NULL이면 생략)
+void game_queue_turn(GameState* g, Dir d, uint64_t t_us); // 방향 전환 예약 - 반대/같은 방향/꽉 참은 무시
+GameStatus game_step(GameState* g, const GameInput* in, GameEvents* ev); // 한 틱 진행 (in, ev는 NULL 가능)
+
+static inline Point game_snake_at(const GameState* g, int i) { // i=0 머리, snake_len-1 꼬리
+    return g->snake[(g->snake_head + i) % SNAKE_CAP];
+}
+
+static inline int occ_get(const uint64_t* occ, Point p) { // 비트보드 칸 읽기 (versus.c도 씀)
+    return (occ[p.y * OCC_WORDS + (p.x >> 6)] >> (p.x & 63)) & 1;
+}
+
+static inline void occ_set(uint64_t* occ, Point p) { occ[p.y * OCC_WORDS + (p.x >> 6)] |= 1ull << (p.x & 63); }
+static inline void occ_clr(uint64_t* occ, Point p) { occ[p.y * OCC_WORDS + (p.x >> 6)] &= ~(1ull << (p.x & 63)); }
+
+static inline int game_occupied(const GameState* g, Point p) { // 뱀이 p를 차지하는지
+    return occ_get(g->occ, p);
+}
@@ -0,0 +1,53 @@
+#!/bin/sh
+# spidev 백엔드 검사 - 실제 보드 없이 가짜 spidev/gpiochip(spidev_shim.c, LD_PRELOAD)로 게임을 돌려서
+# SPI 메시지 구조(CASET/RASET/RAMWR 조각, DC 레벨, bufsiz)와 패널에 들어간 픽셀을 확인
+# 경우마다(패널 크기/회전/칸 크기/12비트):
+#  live   : 자동 조종 한 판을 실시간으로 기록하면서 돌림 - 틱마다 바뀐 칸만 작은 창으로 나감
+#  replay : 그 기록을 최대 속도로 재생 - 전송 스레드가 밀린 프레임을 합쳐서 큰 창으로 나감
+# 둘 다 끝난 화면을 같은 기록의 호스트 백엔드 재생 화면과 비교
+# ./spidev_check.sh [quick]   # quick이면 기본 크기 한 판(약 20초)을 건너뜀. 하나라도 어긋나면 1로 끝남
+
+cd "$(dirname "$0")" || exit 1
+T=$(mktemp -d) || exit 1
+trap 'rm -rf "$T"' EXIT
+S="main.c game.c sim.c autopilot.c render.c dirty.c font5x7.c palette.c st7789.c sched.c input.c hud.c screens.c tiles.c pixops.c replay.c metrics.c versus.c lockstep.c arena.c wake.c framecap.c"
+fails=0
+
+gcc -O2 -shared -fPIC -o "$T/shim.so" spidev_shim.c -ldl || exit 1
+for bpp in 16 12; do
+    gcc -O2 -DNO_SDL -DPANEL_BPP=$bpp -o "$T/spidev$bpp" $S hal_spidev.c -pthread || exit 1
+    gcc -O2 -DNO_SDL -DPANEL_BPP=$bpp -o "$T/host$bpp" $S hal_host.c -pthread || exit 1
+done
+
+verdict() { # $1 이름 - shim.log와 spi.ppm을 host.ppm과 비교
+    line=$(grep "^spishim: .* SPI messages" "$T/shim.log")
+    grep "^spishim: " "$T/shim.log" | grep -v " SPI messages" | sed 's/^/    /'
+    if echo "$line" | grep -q " 0 errors" && cmp -s "$T/spi.ppm" "$T/host.ppm"; then
+        echo "ok    $1: ${line#spishim: }"
+    else
+        echo "FAIL  $1: ${line#spishim: }$(cmp -s "$T/spi.ppm" "$T/host.ppm" || echo ", panel image differs from the host backend")"
+        fails=$((fails + 1))
+    fi
+}
+
+run_case() { # $1 패널, $2 회전, $3 칸 크기, $4 bpp
+    export SNAKE_PANEL=$1 SNAKE_ROTATE=$2 SNAKE_CELL=$3
+    name="$1 rotation $2 cell $3 $4-bit"
+    SNAKE_SEED=5 SNAKE_AUTOPILOT=1 SNAKE_RECORD="$T/r.snkr" LD_PRELOAD="$T/shim.so" SPISHIM_DUMP="$T/spi.ppm" \
+        "$T/spidev$4" > /dev/null 2> "$T/shim.log"
+    SNAKE_REPLAY="$T/r.snkr" SNAKE_DUMP="$T/host.ppm" "$T/host$4" > /dev/null
+    verdict "live   $name"
+    SNAKE_REPLAY="$T/r.snkr" LD_PRELOAD="$T/shim.so" SPISHIM_DUMP="$T/spi.ppm" "$T/spidev$4" > /dev/null 2> "$T/shim.log"
+    verdict "replay $name"
+    unset SNAKE_PANEL SNAKE_ROTATE SNAKE_CELL
+}
+
+[ "$1" = "quick" ] || run_case 240x240 0 10 16
+run_case 240x240 0 30 12
+run_case 240x320 1 30 16
+run_case 240x320 1 30 12
+run_case 240x320 2 24 16
+run_case 240x320 3 24 12
+
+[ $fails -eq 0 ] && echo "spidev check: ok" || echo "spidev check: $fails FAILED"
+[ $fails -eq 0 ]
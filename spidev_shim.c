@@ -0,0 +1,356 @@
+// 가짜 spidev + GPIO 문자 장치 (LD_PRELOAD) - 실제 보드 없이 hal_spidev.c 백엔드를 돌려서 SPI 메시지를 검사
+// open/ioctl/close를 가로채서 /dev/spidev*, /dev/gpiochip* 를 흉내 냄. 라인 fd는 eventfd라 epoll/O_NONBLOCK 읽기도 됨
+// SPI 메시지마다 DC 레벨과 길이를 기록하고 창 구조를 확인:
+//   창 하나 = [DC0 CASET] [DC1 주소 4바이트] [DC0 RASET] [DC1 주소 4바이트] [DC0 RAMWR] [DC1 픽셀 ...]
+//   픽셀 바이트 수 = 창 넓이 x 픽셀 크기(COLMOD) 또는 0 (st7789_init이 주소만 열어 둠), 메시지 하나는 bufsiz 이하
+// 픽셀은 hal_host.c처럼 컨트롤러 메모리(MADCTL/COLMOD 포함)에 풀어 두었다가 끝날 때 유리 화면을 PPM으로 씀
+//
+// gcc -O2 -shared -fPIC -o spidev_shim.so spidev_shim.c -ldl
+// LD_PRELOAD=./spidev_shim.so SPISHIM_DUMP=spi.ppm SNAKE_REPLAY=r.snkr ./snake_spidev   (spidev_check.sh가 돌림)
+//  SPISHIM_DUMP=파일 : 끝날 때 유리 화면 PPM (SNAKE_DUMP와 같은 형식 - 호스트 백엔드 결과와 cmp)
+//  SNAKE_PANEL      : 유리 크기 (게임과 같은 값, 기본 240x240)
+//  SPISHIM_NOEDGE=1 : 엣지 이벤트를 켠 라인 요청을 거절 (엣지를 지원하지 않는 커널 - wakeups.sh가 대체 경로를 잴 때)
+// 끝날 때 stderr에 "spishim: ... N errors" 요약
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+#include "st7789.h"
+
+#define SHIM_FDS 1024
+#define SHIM_BUFSIZ 4096 // 커널 spidev 기본 bufsiz - hal_spidev.c도 /sys에 값이 없으면 이 값
+#define SHIM_MAX_ERRORS 10 // 처음 몇 개만 자세히
+
+enum { FD_NONE, FD_SPI, FD_CHIP, FD_LINE };
+
+static uint8_t fd_kind[SHIM_FDS];
+static uint8_t fd_pin[SHIM_FDS];
+static uint64_t out_pins = 0, out_level = 0; // 출력으로 요청된 핀, 그 핀의 레벨
+static int dc = -1; // DC 레벨 - 출력으로 요청되기 전에는 모름
+static pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
+
+static int (*real_open)(const char*, int, ...);
+static int (*real_close)(int);
+static int (*real_ioctl)(int, unsigned long, ...);
+
+// 패널 흉내 (hal_host.c와 같은 해석)
+static uint16_t ram[ST7789_RAM_W * ST7789_RAM_H];
+static uint8_t cmd = ST7789_NOP, colmod = ST7789_COLMOD_16BIT, madctl = 0;
+static uint8_t params[4], pend[3];
+static int param_n = 0, pend_n = 0;
+static uint16_t xs, xe, ys, ye, cx, cy;
+
+// 창 검사
+static int have_caset = 0, have_raset = 0, in_window = 0;
+static uint64_t win_want = 0, win_got = 0;
+static uint32_t win_msgs = 0; // 지금 창의 픽셀 메시지 수
+
+static uint32_t n_msgs = 0, n_msgs_cmd = 0, n_windows = 0, n_empty = 0, max_len = 0, n_errors = 0;
+static uint64_t n_pixel_bytes = 0, n_window_msgs = 0;
+
+static void fail(const char* fmt, ...) {
+    if (n_errors++ >= SHIM_MAX_ERRORS) return;
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "spishim: ");
+    vfprintf(stderr, fmt, ap);
+    fprintf(stderr, " (message %u)\n", n_msgs);
+    va_end(ap);
+}
+
+static void close_window(void) { // 다음 명령이 오면 창은 끝 - 픽셀 수가 정확히 맞아야 함 (아예 없으면 빈 창)
+    if (!in_window) return;
+    if (win_got == 0) n_empty++;
+    else if (win_got != win_want)
+        fail("window %u-%u x %u-%u got %llu pixel bytes, want %llu", xs, xe, ys, ye, (unsigned long long)win_got,
+             (unsigned long long)win_want);
+    n_window_msgs += win_msgs;
+    in_window = 0;
+}
+
+static void panel_pixel(uint16_t c) {
+    int col = cx, row = cy;
+    if (madctl & ST7789_MADCTL_MV) { col = cy; row = cx; }
+    if (madctl & ST7789_MADCTL_MX) col = ST7789_RAM_W - 1 - col;
+    if (madctl & ST7789_MADCTL_MY) row = ST7789_RAM_H - 1 - row;
+    if (col >= 0 && col < ST7789_RAM_W && row >= 0 && row < ST7789_RAM_H) ram[row * ST7789_RAM_W + col] = c;
+    if (cx++ >= xe) {
+        cx = xs;
+        if (cy++ >= ye) cy = ys;
+    }
+}
+
+static uint16_t from444(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3));
+}
+
+static void command(uint8_t b) {
+    close_window();
+    if (pend_n) fail("command 0x%02X after %d stray pixel bytes", b, pend_n);
+    cmd = b;
+    param_n = 0;
+    pend_n = 0;
+    if (b == ST7789_CASET) have_caset = 0;
+    if (b == ST7789_RASET) have_raset = 0;
+    if (b != ST7789_RAMWR) return;
+    if (!have_caset || !have_raset) fail("RAMWR without a fresh CASET and RASET");
+    have_caset = have_raset = 0;
+    uint64_t area = (uint64_t)(xe - xs + 1) * (uint64_t)(ye - ys + 1);
+    if (colmod == ST7789_COLMOD_12BIT && (area & 1)) fail("12-bit window %u-%u x %u-%u has an odd pixel count", xs, xe, ys, ye);
+    win_want = colmod == ST7789_COLMOD_12BIT ? area * 3 / 2 : area * 2;
+    win_got = 0;
+    win_msgs = 0;
+    in_window = 1;
+    n_windows++;
+    cx = xs;
+    cy = ys;
+}
+
+static void data(const uint8_t* p, uint32_t len) { // DC=1 메시지 하나 - 마지막 명령의 인자 또는 픽셀
+    if (cmd == ST7789_CASET || cmd == ST7789_RASET) {
+        if (param_n != 0 || len != 4) fail("0x%02X address in a %u-byte message (expected one 4-byte message)", cmd, len);
+        for (uint32_t i = 0; i < len && param_n < 4; i++) params[param_n++] = p[i];
+        if (param_n < 4) return;
+        uint16_t a0 = (uint16_t)((params[0] << 8) | params[1]), a1 = (uint16_t)((params[2] << 8) | params[3]);
+        uint16_t lim = cmd == ST7789_CASET ? ST7789_RAM_W : ST7789_RAM_H; // MV면 바뀌지만 둘 다 320 이하
+        if (a0 > a1 || a1 >= ST7789_RAM_H || (!(madctl & ST7789_MADCTL_MV) && a1 >= lim))
+            fail("0x%02X range %u-%u out of frame memory", cmd, a0, a1);
+        if (cmd == ST7789_CASET) { xs = a0; xe = a1; have_caset = 1; }
+        else { ys = a0; ye = a1; have_raset = 1; }
+        return;
+    }
+    if (cmd == ST7789_RAMWR) {
+        win_got += len;
+        win_msgs++;
+        n_pixel_bytes += len;
+        for (uint32_t i = 0; i < len; i++) {
+            pend[pend_n++] = p[i];
+            if (colmod == ST7789_COLMOD_12BIT) {
+                if (pend_n < 3) continue;
+                panel_pixel(from444(pend[0] >> 4, pend[0] & 0x0F, pend[1] >> 4));
+                panel_pixel(from444(pend[1] & 0x0F, pend[2] >> 4, pend[2] & 0x0F));
+            } else {
+                if (pend_n < 2) continue;
+                panel_pixel((uint16_t)((pend[0] << 8) | pend[1]));
+            }
+            pend_n = 0;
+        }
+        return;
+    }
+    if (len != 1) fail("command 0x%02X took a %u-byte parameter message", cmd, len);
+    if (cmd == ST7789_COLMOD) colmod = p[0];
+    else if (cmd == ST7789_MADCTL) madctl = p[0];
+}
+
+static void spi_message(const struct spi_ioc_transfer* t) {
+    const uint8_t* p = (const uint8_t*)(uintptr_t)t->tx_buf;
+    n_msgs++;
+    if (t->len > max_len) max_len = t->len;
+    if (t->len == 0 || !p) fail("empty transfer");
+    if (t->len > SHIM_BUFSIZ) fail("%u-byte message exceeds bufsiz %u", t->len, SHIM_BUFSIZ);
+    if (t->rx_buf) fail("unexpected rx buffer");
+    if (dc < 0) {
+        fail("SPI before DC is an output");
+        return;
+    }
+    if (dc == 0) { // 명령 - 인자 없는 명령은 여러 개가 한 메시지에 이어질 수 있음
+        n_msgs_cmd++;
+        for (uint32_t i = 0; i < t->len; i++) command(p[i]);
+    } else {
+        data(p, t->len);
+    }
+}
+
+static int is_path(const char* path, const char* prefix) {
+    return path && strncmp(path, prefix, strlen(prefix)) == 0;
+}
+
+static int fake_open(int kind) {
+    int fd = real_open("/dev/null", O_RDWR | O_CLOEXEC);
+    if (fd >= 0 && fd < SHIM_FDS) fd_kind[fd] = (uint8_t)kind;
+    return fd;
+}
+
+static int do_open(const char* path, int flags, mode_t mode) {
+    if (is_path(path, "/dev/spidev")) return fake_open(FD_SPI);
+    if (is_path(path, "/dev/gpiochip")) return fake_open(FD_CHIP);
+    return real_open(path, flags, mode);
+}
+
+static mode_t open_mode(int flags, va_list ap) {
+    return (flags & (O_CREAT | O_TMPFILE)) ? (mode_t)va_arg(ap, int) : 0;
+}
+
+int open(const char* path, int flags, ...) {
+    va_list ap;
+    va_start(ap, flags);
+    mode_t m = open_mode(flags, ap);
+    va_end(ap);
+    return do_open(path, flags, m);
+}
+
+int open64(const char* path, int flags, ...) {
+    va_list ap;
+    va_start(ap, flags);
+    mode_t m = open_mode(flags, ap);
+    va_end(ap);
+    return do_open(path, flags, m);
+}
+
+int __open_2(const char* path, int flags) { return do_open(path, flags, 0); }
+int __open64_2(const char* path, int flags) { return do_open(path, flags, 0); }
+
+int close(int fd) {
+    if (fd >= 0 && fd < SHIM_FDS) fd_kind[fd] = FD_NONE;
+    return real_close(fd);
+}
+
+static void line_config(uint8_t pin, const struct gpio_v2_line_config* cfg) {
+    if (!(cfg->flags & GPIO_V2_LINE_FLAG_OUTPUT)) {
+        out_pins &= ~(1ull << pin);
+        return;
+    }
+    out_pins |= 1ull << pin;
+    for (uint32_t i = 0; i < cfg->num_attrs; i++) {
+        if (cfg->attrs[i].attr.id != GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES || !(cfg->attrs[i].mask & 1)) continue;
+        if (cfg->attrs[i].attr.values & 1) out_level |= 1ull << pin;
+        else out_level &= ~(1ull << pin);
+    }
+    if (pin == TFT_DC) dc = (int)(out_level >> pin & 1);
+}
+
+static int gpio_ioctl(int kind, int fd, unsigned long req, void* arg) {
+    if (kind == FD_CHIP && req == GPIO_V2_GET_LINE_IOCTL) {
+        struct gpio_v2_line_request* r = arg;
+        if (r->num_lines != 1 || r->offsets[0] >= 64) return -1;
+        if ((r->config.flags & (GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING)) && getenv("SPISHIM_NOEDGE")) {
+            errno = EINVAL;
+            return -1;
+        }
+        int lfd = eventfd(0, EFD_CLOEXEC); // 엣지는 안 생기지만 epoll에 넣고 O_NONBLOCK으로 읽을 수 있는 fd
+        if (lfd < 0 || lfd >= SHIM_FDS) return -1;
+        fd_kind[lfd] = FD_LINE;
+        fd_pin[lfd] = (uint8_t)r->offsets[0];
+        line_config(fd_pin[lfd], &r->config);
+        r->fd = lfd;
+        return 0;
+    }
+    if (kind == FD_CHIP && req == GPIO_V2_GET_LINEINFO_IOCTL) {
+        struct gpio_v2_line_info* info = arg;
+        info->flags = (info->offset < 64 && (out_pins >> info->offset & 1)) ? GPIO_V2_LINE_FLAG_OUTPUT : GPIO_V2_LINE_FLAG_INPUT;
+        return 0;
+    }
+    if (kind == FD_LINE) {
+        uint8_t pin = fd_pin[fd];
+        if (req == GPIO_V2_LINE_SET_CONFIG_IOCTL) {
+            line_config(pin, arg);
+            return 0;
+        }
+        if (req == GPIO_V2_LINE_SET_VALUES_IOCTL) {
+            struct gpio_v2_line_values* v = arg;
+            if (!(v->mask & 1)) return 0;
+            if (!(out_pins >> pin & 1)) fail("write to input pin %u", pin);
+            if (v->bits & 1) out_level |= 1ull << pin;
+            else out_level &= ~(1ull << pin);
+            if (pin == TFT_DC) dc = (int)(v->bits & 1);
+            return 0;
+        }
+        if (req == GPIO_V2_LINE_GET_VALUES_IOCTL) { // 입력은 풀업 - 버튼은 안 눌림
+            struct gpio_v2_line_values* v = arg;
+            v->bits = (out_pins >> pin & 1) ? (out_level >> pin & 1) : 1;
+            return 0;
+        }
+    }
+    fail("unhandled GPIO ioctl 0x%lx", req);
+    return -1;
+}
+
+static int spi_ioctl(unsigned long req, void* arg) {
+    if (_IOC_TYPE(req) == SPI_IOC_MAGIC && _IOC_NR(req) == 0 && _IOC_DIR(req) == _IOC_WRITE) { // SPI_IOC_MESSAGE(n)
+        uint32_t n = _IOC_SIZE(req) / sizeof(struct spi_ioc_transfer);
+        const struct spi_ioc_transfer* t = arg;
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            spi_message(&t[i]);
+            total += t[i].len;
+        }
+        return (int)total;
+    }
+    if (req == SPI_IOC_WR_MODE || req == SPI_IOC_WR_BITS_PER_WORD || req == SPI_IOC_WR_MAX_SPEED_HZ) return 0;
+    fail("unhandled SPI ioctl 0x%lx", req);
+    return -1;
+}
+
+int ioctl(int fd, unsigned long req, ...) {
+    va_list ap;
+    va_start(ap, req);
+    void* arg = va_arg(ap, void*);
+    va_end(ap);
+    int kind = fd >= 0 && fd < SHIM_FDS ? fd_kind[fd] : FD_NONE;
+    if (kind == FD_NONE) return real_ioctl(fd, req, arg);
+    pthread_mutex_lock(&mu); // 전송 스레드(SPI, DC)와 게임 스레드(백라이트 등)가 같이 부름
+    int r = kind == FD_SPI ? spi_ioctl(req, arg) : gpio_ioctl(kind, fd, req, arg);
+    pthread_mutex_unlock(&mu);
+    return r;
+}
+
+static void dump_ppm(const char* path) { // hal_host.c의 hal_host_panel + dump_ppm과 같은 변환
+    int pw = 240, ph = 240;
+    const char* s = getenv("SNAKE_PANEL");
+    if (s) sscanf(s, "%dx%d", &pw, &ph);
+    int w = (madctl & ST7789_MADCTL_MV) ? ph : pw, h = (madctl & ST7789_MADCTL_MV) ? pw : ph;
+    uint16_t* view = malloc(sizeof(uint16_t) * (size_t)pw * (size_t)ph);
+    FILE* f = fopen(path, "wb");
+    if (!view || !f) {
+        free(view);
+        if (f) fclose(f);
+        return;
+    }
+    for (int r = 0; r < ph; r++)
+        for (int c = 0; c < pw; c++) {
+            int u = (madctl & ST7789_MADCTL_MX) ? pw - 1 - c : c;
+            int v = (madctl & ST7789_MADCTL_MY) ? ph - 1 - r : r;
+            int x = (madctl & ST7789_MADCTL_MV) ? v : u, y = (madctl & ST7789_MADCTL_MV) ? u : v;
+            view[y * w + x] = ram[r * ST7789_RAM_W + c];
+        }
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int i = 0; i < w * h; i++) {
+        uint16_t c = view[i];
+        uint8_t rgb[3] = { (uint8_t)(((c >> 11) & 0x1F) << 3), (uint8_t)(((c >> 5) & 0x3F) << 2), (uint8_t)((c & 0x1F) << 3) };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    free(view);
+}
+
+__attribute__((constructor)) static void shim_init(void) {
+    real_open = (int (*)(const char*, int, ...))dlsym(RTLD_NEXT, "open");
+    real_close = (int (*)(int))dlsym(RTLD_NEXT, "close");
+    real_ioctl = (int (*)(int, unsigned long, ...))dlsym(RTLD_NEXT, "ioctl");
+    for (int i = 0; i < ST7789_RAM_W * ST7789_RAM_H; i++) ram[i] = 0xF81F; // 첫 프레임이 유리 전체를 덮어야 함
+}
+
+__attribute__((destructor)) static void shim_report(void) {
+    pthread_mutex_lock(&mu);
+    close_window();
+    const char* s = getenv("SPISHIM_DUMP");
+    if (s) dump_ppm(s);
+    uint32_t filled = n_windows - n_empty;
+    fprintf(stderr, "spishim: %u SPI messages (%u command, max %u bytes), %u windows (%u empty, %.2f pixel messages per filled), %llu pixel bytes, %u errors\n",
+            n_msgs, n_msgs_cmd, max_len, n_windows, n_empty, filled ? (double)n_window_msgs / filled : 0.0,
+            (unsigned long long)n_pixel_bytes, n_errors);
+    pthread_mutex_unlock(&mu);
+}
@@ -1,98 +1,203 @@
-#include <bcm2835.h>
 #include <stdio.h>
 
 #include "st7789.h"
 
+#include "hal.h"
+#include "pixops.h"
+
+static St7789Stats stats;
+
+St7789Geometry st7789_geom = { 240, 240, 240, 240, 0, 0x00, 0, 0 };
+
+// Pre-packed big-endian RGB565 line buffer reused by every bulk write
+static uint8_t chunk[ST7789_CHUNK_PIXELS * 2];
+static uint32_t chunk_filled = 0; // pixels of chunk_color already packed
+static uint16_t chunk_color = 0;
+
+static void pin_dc(int data) { hal_gpio_write(TFT_DC, data ? HAL_HIGH : HAL_LOW); }
+static void pin_rst(int high) { hal_gpio_write(TFT_RST, high ? HAL_HIGH : HAL_LOW); }
+
+static void wait_ms(uint32_t ms) { // Commands queued by a batching transport must be out before the wait starts
+    hal_spi_flush();
+    hal_delay_ms(ms);
+}
+
+static void spi_byte(uint8_t b) {
+    hal_spi_write(&b, 1);
+    stats.transactions++;
+    stats.bytes++;
+}
+
+static void spi_bulk(const uint8_t* buf, uint32_t len) {
+    hal_spi_write(buf, len);
+    stats.transactions++;
+    stats.bytes += len;
+}
+
 void writeCommand(uint8_t cmd) {
-    bcm2835_gpio_clr(TFT_DC);
-    bcm2835_spi_transfer(cmd);
+    pin_dc(0);
+    spi_byte(cmd);
 }
 
 void writeData(uint8_t data) {
-    bcm2835_gpio_set(TFT_DC);
-    bcm2835_spi_transfer(data);
+    pin_dc(1);
+    spi_byte(data);
 }
 
-void st7789_init() {
-    bcm2835_spi_begin();
-    bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_8);
-    
-    // Hardware reset
-    bcm2835_gpio_clr(TFT_RST);
-    delay(100);
-    bcm2835_gpio_set(TFT_RST);
-    delay(100);
+static void writeData16(uint16_t a, uint16_t b) { // 주소 범위 4바이트를 한 번에 전송
+    uint8_t buf[4] = { a >> 8, a & 0xFF, b >> 8, b & 0xFF };
+    pin_dc(1);
+    spi_bulk(buf, sizeof(buf));
+}
 
-    writeCommand(ST7789_SWRESET); // Software reset
-    delay(150);
+int st7789_setGeometry(uint16_t panel_w, uint16_t panel_h, uint8_t rotation) {
+    static const uint8_t madctl[4] = { // quarter turns of the default orientation
+        0x00,
+        ST7789_MADCTL_MX | ST7789_MADCTL_MV,
+        ST7789_MADCTL_MX | ST7789_MADCTL_MY,
+        ST7789_MADCTL_MY | ST7789_MADCTL_MV,
+    };
+    if (panel_w == 0 || panel_h == 0 || panel_w > ST7789_RAM_W || panel_h > ST7789_RAM_H || rotation > 3) return 0;
+
+    St7789Geometry g = { panel_w, panel_h, panel_w, panel_h, rotation, madctl[rotation], 0, 0 };
+    // The glass covers the top-left of frame memory; mirroring an axis moves it to the far end of that axis
+    uint16_t col_off = (g.madctl & ST7789_MADCTL_MX) ? ST7789_RAM_W - panel_w : 0;
+    uint16_t row_off = (g.madctl & ST7789_MADCTL_MY) ? ST7789_RAM_H - panel_h : 0;
+    if (g.madctl & ST7789_MADCTL_MV) { // x now walks frame memory rows
+        g.width = panel_h;
+        g.height = panel_w;
+        g.x_off = row_off;
+        g.y_off = col_off;
+    } else {
+        g.x_off = col_off;
+        g.y_off = row_off;
+    }
+    st7789_geom = g;
+    return 1;
+}
+
+void st7789_init(int warm, uint8_t bpp) {
+    hal_spi_begin();
+
+    // Delays are the datasheet minimums rather than generous round numbers:
+    // RESX low >= 10 us, 120 ms from reset to SLPOUT, 5 ms after SLPOUT before the next command.
+    // A hardware reset already does everything SWRESET does, so SWRESET is not sent.
+    if (!warm) {
+        pin_rst(0);
+        wait_ms(1);
+        pin_rst(1);
+        wait_ms(120);
+    }
+    // Warm restart: the controller kept power and RST was never pulled low, so it is already
+    // past reset. SLPOUT is harmless if it is awake and brings it back if it was put to sleep.
 
     writeCommand(ST7789_SLPOUT);  // Sleep out
-    delay(500);
+    wait_ms(5);
 
-    writeCommand(ST7789_COLMOD);  // Set color mode
-    writeData(0x55);              // 16-bit color
-    delay(10);
+    st7789_setColorMode(bpp);
 
     writeCommand(ST7789_MADCTL);
-    writeData(0x00);              // Normal display
+    writeData(st7789_geom.madctl); // Rotation (0x00 = normal)
 
-    writeCommand(ST7789_CASET);
-    writeData(0x00); writeData(0x00); // XSTART = 0
-    writeData(ST7789_TFTWIDTH >> 8); writeData(ST7789_TFTWIDTH & 0xFF); // XEND
+    st7789_setWindow(0, 0, ST7789_TFTWIDTH - 1, ST7789_TFTHEIGHT - 1);
+    hal_spi_flush();
+    // DISPON is left to st7789_displayOn so the first frame can be written while the display is still off
+}
 
-    writeCommand(ST7789_RASET);
-    writeData(0x00); writeData(0x00); // YSTART = 0
-    writeData(ST7789_TFTHEIGHT >> 8); writeData(ST7789_TFTHEIGHT & 0xFF); // YEND
+void st7789_displayOn(void) {
+    writeCommand(ST7789_DISPON);  // Display on - no wait needed before further RAM writes
+    hal_spi_flush();
+}
 
-    writeCommand(ST7789_DISPON);  // Display on
-    delay(100);
+void st7789_flush(void) {
+    hal_spi_flush();
 }
 
-void st7789_fillScreen(uint16_t color) {
-    uint8_t hi = color >> 8, lo = color & 0xFF;
-    writeCommand(ST7789_RASET);
-    writeData(0); writeData(0);
-    writeData(ST7789_TFTHEIGHT >> 8); writeData(ST7789_TFTHEIGHT & 0xFF);
-    
-    writeCommand(ST7789_CASET);
-    writeData(0); writeData(0);
-    writeData(ST7789_TFTWIDTH >> 8); writeData(ST7789_TFTWIDTH & 0xFF);
-    
-    writeCommand(ST7789_RAMWR);
-    bcm2835_gpio_set(TFT_DC);
-
-    int i, j;
-    for (i = 0; i < ST7789_TFTHEIGHT; i++) {
-        for (j = 0; j < ST7789_TFTWIDTH; j++) {
-            bcm2835_spi_transfer(hi);
-            bcm2835_spi_transfer(lo);
+void st7789_setColorMode(uint8_t bpp) { // 픽셀 전송 형식 변경
+    writeCommand(ST7789_COLMOD);
+    writeData(bpp == 12 ? ST7789_COLMOD_12BIT : ST7789_COLMOD_16BIT);
+}
+
+void st7789_setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) { // 창 설정 후 RAMWR까지
+    uint16_t xo = st7789_geom.x_off, yo = st7789_geom.y_off; // 회전에 따라 유리가 메모리 중간에서 시작
+    writeCommand(ST7789_CASET); // 열 주소 설정
+    writeData16((uint16_t)(x0 + xo), (uint16_t)(x1 + xo));
+    writeCommand(ST7789_RASET); // 행 주소 설정
+    writeData16((uint16_t)(y0 + yo), (uint16_t)(y1 + yo));
+    writeCommand(ST7789_RAMWR); // 메모리 쓰기 시작
+    pin_dc(1); // 이후는 픽셀 데이터
+    stats.windows++;
+}
+
+void st7789_pushBytes(const uint8_t* buf, uint32_t len) { // 이미 패킹된 픽셀 바이트 그대로 전송
+    spi_bulk(buf, len);
+}
+
+void st7789_pushColor(uint16_t color, uint32_t n) { // 같은 색 n픽셀을 청크 단위로 전송
+    if (color != chunk_color) { chunk_color = color; chunk_filled = 0; }
+    uint32_t want = n < ST7789_CHUNK_PIXELS ? n : ST7789_CHUNK_PIXELS;
+    if (chunk_filled < want) { // 필요한 만큼만 미리 패킹
+        px_fill_be(&chunk[chunk_filled * 2], color, want - chunk_filled);
+        chunk_filled = want;
+    }
+    while (n > 0) {
+        uint32_t k = n < ST7789_CHUNK_PIXELS ? n : ST7789_CHUNK_PIXELS;
+        spi_bulk(chunk, k * 2);
+        n -= k;
+    }
+}
+
+void st7789_pushPixels(const uint16_t* px, uint32_t n) { // RGB565 배열을 big-endian으로 패킹해 전송
+    chunk_filled = 0; // 청크 내용을 덮어쓰므로 캐시 무효화
+    while (n > 0) {
+        uint32_t k = n < ST7789_CHUNK_PIXELS ? n : ST7789_CHUNK_PIXELS;
+        px_swap_be(chunk, px, k);
+        spi_bulk(chunk, k * 2);
+        px += k;
+        n -= k;
+    }
+}
+
+void st7789_pushRegion(const uint16_t* px, uint32_t stride, uint16_t w, uint16_t h) { // 여러 줄을 청크에 이어 붙여 전송
+    chunk_filled = 0;
+    uint32_t k = 0; // 청크에 채운 픽셀 수
+    for (uint16_t row = 0; row < h; row++) {
+        const uint16_t* src = px + (uint32_t)row * stride;
+        uint32_t left = w;
+        while (left > 0) { // 청크에 들어가는 만큼씩 한 번에 바이트 교환
+            uint32_t m = ST7789_CHUNK_PIXELS - k;
+            if (m > left) m = left;
+            px_swap_be(&chunk[k * 2], src, m);
+            src += m;
+            left -= m;
+            k += m;
+            if (k == ST7789_CHUNK_PIXELS) { spi_bulk(chunk, k * 2); k = 0; }
         }
     }
+    if (k > 0) spi_bulk(chunk, k * 2);
+}
+
+void st7789_fillScreen(uint16_t color) {
+    st7789_setWindow(0, 0, ST7789_TFTWIDTH - 1, ST7789_TFTHEIGHT - 1);
+    st7789_pushColor(color, (uint32_t)ST7789_TFTWIDTH * ST7789_TFTHEIGHT);
+    hal_spi_flush();
 }
 
 void st7789_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) { // 사각형 그리기
     if (x >= ST7789_TFTWIDTH || y >= ST7789_TFTHEIGHT) return; // 범위 밖이면 무시
     if (x + w > ST7789_TFTWIDTH)  w = ST7789_TFTWIDTH - x; // 너비 조정
     if (y + h > ST7789_TFTHEIGHT) h = ST7789_TFTHEIGHT - y; // 높이 조정
+    if (w == 0 || h == 0) return;
 
-    uint8_t hi = color >> 8, lo = color & 0xFF; // 색상 분리
-
-    writeCommand(ST7789_CASET); // 열 주소 설정
-    writeData(x >> 8); writeData(x & 0xFF); // 시작 열
-    uint16_t x2 = x + w - 1; // 끝 열
-    writeData(x2 >> 8); writeData(x2 & 0xFF); // 끝 열
+    st7789_setWindow(x, y, x + w - 1, y + h - 1);
+    st7789_pushColor(color, (uint32_t)w * (uint32_t)h); // 총 픽셀 수만큼 전송
+    hal_spi_flush();
+}
 
-    writeCommand(ST7789_RASET); // 행 주소 설정
-    writeData(y >> 8); writeData(y & 0xFF); // 시작 행
-    uint16_t y2 = y + h - 1; // 끝 행
-    writeData(y2 >> 8); writeData(y2 & 0xFF); // 끝 행
+const St7789Stats* st7789_stats(void) { return &stats; }
 
-    writeCommand(ST7789_RAMWR); // 메모리 쓰기 시작
-    bcm2835_gpio_set(TFT_DC); // 데이터 모드
-
-    uint32_t n = (uint32_t)w * (uint32_t)h; // 총 픽셀 수
-    for (uint32_t i = 0; i < n; i++) { // 픽셀 데이터 전송
-        bcm2835_spi_transfer(hi); // 상위 바이트
-        bcm2835_spi_transfer(lo); // 하위 바이트
-    }
+void st7789_resetStats(void) {
+    stats.transactions = 0;
+    stats.bytes = 0;
+    stats.windows = 0;
 }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <bcm2835.h>
+#include <stdint.h>
 #include <stdio.h>
 
 // Pin definitions (Adjust these for your specific hardware)
@@ -8,8 +8,27 @@
 #define TFT_DC      25
 #define TFT_RST     24
 
-#define ST7789_TFTWIDTH  240
-#define ST7789_TFTHEIGHT 240
+// Controller frame memory is 240 columns x 320 rows; the glass may show all of it or part of it
+#define ST7789_RAM_W 240
+#define ST7789_RAM_H 320
+#define ST7789_MAX_DIM ST7789_RAM_H // longest side in any rotation - bound for fixed-size line buffers
+
+// Panel geometry, chosen once at startup (st7789_setGeometry) before anything is drawn
+typedef struct {
+    uint16_t width, height;    // logical size after rotation - what the game draws into
+    uint16_t panel_w, panel_h; // native glass size in portrait (240x240, 240x320)
+    uint8_t rotation;          // quarter turns, 0..3
+    uint8_t madctl;            // MADCTL value for that rotation
+    uint16_t x_off, y_off;     // where the glass starts in frame memory for that rotation
+} St7789Geometry;
+
+extern St7789Geometry st7789_geom;
+
+#define ST7789_TFTWIDTH  (st7789_geom.width)
+#define ST7789_TFTHEIGHT (st7789_geom.height)
+
+// Pixels packed per bulk SPI write (one line of the widest geometry)
+#define ST7789_CHUNK_PIXELS ST7789_MAX_DIM
 
 // ST7789 commands
 #define ST7789_NOP     0x00
@@ -22,12 +41,50 @@
 #define ST7789_MADCTL  0x36
 #define ST7789_COLMOD  0x3A
 
+// MADCTL bits
+#define ST7789_MADCTL_MY 0x80 // row address order
+#define ST7789_MADCTL_MX 0x40 // column address order
+#define ST7789_MADCTL_MV 0x20 // row/column exchange
+
+// COLMOD parameters
+#define ST7789_COLMOD_16BIT 0x55 // RGB565, 2 bytes per pixel
+#define ST7789_COLMOD_12BIT 0x53 // RGB444, 2 pixels per 3 bytes
+
+// SPI traffic counters
+typedef struct {
+    uint32_t transactions; // number of SPI transfer calls
+    uint32_t bytes;        // bytes clocked out
+    uint32_t windows;      // CASET/RASET/RAMWR windows opened
+} St7789Stats;
+
+// Select the glass size and rotation. Call before st7789_init and before anything reads ST7789_TFTWIDTH.
+// Returns 0 (geometry unchanged) if the size does not fit the controller or rotation is not 0..3
+int st7789_setGeometry(uint16_t panel_w, uint16_t panel_h, uint8_t rotation);
+
 void writeCommand(uint8_t cmd);
 
 void writeData(uint8_t data);
 
-void st7789_init();
+// Reset (unless warm), wake and configure the panel for bpp (16 or 12). The display stays off.
+// warm: the controller kept power and RST since the last run, so the hardware reset is skipped
+void st7789_init(int warm, uint8_t bpp);
+
+void st7789_displayOn(void); // DISPON - call once the first frame is in panel RAM
+void st7789_flush(void); // Send whatever the SPI transport is still batching (end of a frame)
+
+void st7789_setColorMode(uint8_t bpp); // 16 or 12
+
+// Streaming pixel API: open a window once, then push pixels in bulk
+// (pushColor/pushPixels/pushRegion/fillRect/fillScreen pack 16-bit pixels)
+void st7789_setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void st7789_pushBytes(const uint8_t* buf, uint32_t len); // already packed for the current COLMOD
+void st7789_pushColor(uint16_t color, uint32_t n);
+void st7789_pushPixels(const uint16_t* px, uint32_t n);
+void st7789_pushRegion(const uint16_t* px, uint32_t stride, uint16_t w, uint16_t h); // stride 간격의 w*h 영역
 
 void st7789_fillScreen(uint16_t color);
 
 void st7789_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+const St7789Stats* st7789_stats(void);
+void st7789_resetStats(void);
@@ -0,0 +1,96 @@
+// ST7789 드라이버 검사(별도 프로그램) - 호스트 백엔드에 연결해서 전송 횟수/바이트/창 수와 패널 화면을 확인
+// 화면 채우기와 창 채우기(청크 하나, 청크 여러 개 + 꼬리, 가장자리에서 잘림)를 회전한 크기까지 돌림
+//
+// gcc -O2 -o st7789_check st7789_check.c st7789.c hal_host.c pixops.c
+// ./st7789_check   # 실패하면 어긋난 값을 출력하고 1로 끝남
+
+#include <stdio.h>
+
+#include "hal.h"
+#include "st7789.h"
+
+static int failures = 0;
+
+static void expect(const char* what, uint32_t got, uint32_t want) {
+    if (got == want) return;
+    printf("FAIL %s: %u (want %u)\n", what, got, want);
+    failures++;
+}
+
+static uint32_t chunks(uint32_t n) { // pushColor가 n픽셀을 보내는 bulk 전송 수
+    return (n + ST7789_CHUNK_PIXELS - 1) / ST7789_CHUNK_PIXELS;
+}
+
+// 창 하나 = CASET(1) + 주소(4) + RASET(1) + 주소(4) + RAMWR(1), 전송 5번
+#define WINDOW_XFERS 5
+#define WINDOW_BYTES 11
+
+static void expect_stats(const char* what, uint32_t px) {
+    const St7789Stats* s = st7789_stats();
+    char name[96];
+    snprintf(name, sizeof(name), "%s transactions", what);
+    expect(name, s->transactions, WINDOW_XFERS + chunks(px));
+    snprintf(name, sizeof(name), "%s bytes", what);
+    expect(name, s->bytes, WINDOW_BYTES + px * 2);
+    snprintf(name, sizeof(name), "%s windows", what);
+    expect(name, s->windows, 1);
+}
+
+static void expect_panel(const char* what, int x, int y, int w, int h, uint16_t in, uint16_t out) { // 사각형 안은 in, 밖은 out
+    const uint16_t* p = hal_host_panel();
+    int bad = 0;
+    for (int py = 0; py < ST7789_TFTHEIGHT; py++)
+        for (int px = 0; px < ST7789_TFTWIDTH; px++) {
+            int inside = px >= x && px < x + w && py >= y && py < y + h;
+            if (p[py * ST7789_TFTWIDTH + px] != (inside ? in : out)) bad++;
+        }
+    if (bad) {
+        printf("FAIL %s: %d pixels differ on the panel\n", what, bad);
+        failures++;
+    }
+}
+
+static void fill_rect(const char* what, int x, int y, int w, int h, int cw, int ch, uint16_t bg, uint16_t c) {
+    st7789_resetStats();
+    st7789_fillRect(x, y, w, h, c);
+    expect_stats(what, (uint32_t)cw * ch);
+    expect_panel(what, x, y, cw, ch, c, bg);
+    st7789_fillScreen(bg);
+}
+
+static void run(uint16_t panel_w, uint16_t panel_h, uint8_t rotation) {
+    if (!st7789_setGeometry(panel_w, panel_h, rotation)) {
+        printf("FAIL geometry %ux%u rotation %u refused\n", panel_w, panel_h, rotation);
+        failures++;
+        return;
+    }
+    st7789_init(0, 16);
+    int w = ST7789_TFTWIDTH, h = ST7789_TFTHEIGHT;
+    printf("%ux%u rotation %u (%dx%d)\n", panel_w, panel_h, rotation, w, h);
+
+    st7789_resetStats();
+    st7789_fillScreen(0x1234);
+    expect_stats("fillScreen", (uint32_t)w * h);
+    expect_panel("fillScreen", 0, 0, w, h, 0x1234, 0x1234);
+
+    fill_rect("fillRect one chunk", 10, 20, 33, 7, 33, 7, 0x1234, 0xF800);       // 231픽셀 - 전송 하나
+    fill_rect("fillRect chunk tail", 5, 3, 100, 7, 100, 7, 0x1234, 0x07E0);      // 700픽셀 - 청크 둘 + 꼬리 60
+    fill_rect("fillRect clipped", w - 10, h - 6, 40, 40, 10, 6, 0x1234, 0x001F); // 가장자리에서 10x6으로 잘림
+
+    st7789_resetStats();
+    st7789_fillRect(w, 0, 8, 8, 0xFFFF); // 화면 밖 - 아무것도 안 보냄
+    expect("fillRect outside transactions", st7789_stats()->transactions, 0);
+}
+
+int main(void) {
+    if (!hal_init()) return 1;
+    hal_spi_begin();
+    run(240, 240, 0);
+    run(240, 240, 1);
+    run(240, 320, 1);
+    run(240, 320, 2);
+    hal_spi_end();
+    hal_close();
+    printf(failures ? "st7789 check: %d FAILED\n" : "st7789 check: ok\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,77 @@
+#include "tiles.h"
+
+#include "config.h"
+#include "palette.h"
+#include "render.h"
+
+#define TILE_STRIDE ((CELL + 1) / 2) // 타일 한 줄 바이트 수
+
+static uint8_t atlas[TILE_COUNT][CELL_MAX * (CELL_MAX + 1) / 2]; // 가장 큰 칸 기준 - 앞쪽 CELL * TILE_STRIDE만 씀
+
+static int edge(int x, int y) { // 타일 테두리 1픽셀
+    return x == 0 || y == 0 || x == CELL - 1 || y == CELL - 1;
+}
+
+static uint16_t head_px(int u, int v, uint16_t fill, uint16_t rim) { // 오른쪽을 보는 머리 - u: 진행 방향 좌표, v: 옆 방향 좌표
+    int eu = CELL * 6 / 10, es = CELL / 5; // 눈 위치/크기 (5픽셀보다 작은 칸은 눈 없음)
+    int in_u = u >= eu && u < eu + es;
+    if (in_u && ((v >= es && v < 2 * es) || (v >= CELL - 2 * es && v < CELL - es))) {
+        return u == eu + es - 1 ? C_BLACK : C_WHITE; // 앞쪽 픽셀은 눈동자
+    }
+    return edge(u, v) ? rim : fill;
+}
+
+static uint16_t tile_px(TileId t, int x, int y) { // 타일 t의 (x, y) 픽셀 색
+    int m = CELL / 5; // 꼬리/음식 여백
+    int c2 = CELL - 1; // 중심 * 2
+    int dx = 2 * x - c2, dy = 2 * y - c2;
+    int r = CELL - 2 * m + 1; // 음식 반지름 * 2
+    uint16_t fill = C_GREEN, rim = C_DKGREEN;
+
+    if (t >= TILE_BODY2 && t != TILE_HUD2) { // 두 번째 뱀: 색만 바꾸고 모양은 첫 번째 뱀 타일
+        fill = C_RED;
+        rim = C_DKRED;
+        t = t == TILE_BODY2 ? TILE_BODY : t == TILE_TAIL2 ? TILE_TAIL : (TileId)(t - TILE_HEAD2_UP + TILE_HEAD_UP);
+    }
+
+    switch (t) {
+    case TILE_BODY:
+        return edge(x, y) ? rim : fill;
+    case TILE_TAIL:
+        if (x < m || y < m || x >= CELL - m || y >= CELL - m) return C_BLACK;
+        return (x == m || y == m || x == CELL - m - 1 || y == CELL - m - 1) ? rim : fill;
+    case TILE_FOOD:
+        if (x == CELL / 2 && y == 0) return C_DKGREEN; // 꼭지
+        return dx * dx + dy * dy <= r * r ? C_YELLOW : C_BLACK;
+    case TILE_HUD:
+        return edge(x, y) ? C_NAVY : C_BLUE;
+    case TILE_HUD2:
+        return edge(x, y) ? C_DKRED : C_RED;
+    case TILE_HEAD_RIGHT:
+        return head_px(x, y, fill, rim);
+    case TILE_HEAD_LEFT:
+        return head_px(CELL - 1 - x, y, fill, rim);
+    case TILE_HEAD_DOWN:
+        return head_px(y, x, fill, rim);
+    case TILE_HEAD_UP:
+        return head_px(CELL - 1 - y, x, fill, rim);
+    default:
+        return C_BLACK;
+    }
+}
+
+void tiles_init(void) {
+    for (int t = 0; t < TILE_COUNT; t++) {
+        for (int y = 0; y < CELL; y++) {
+            uint8_t* row = &atlas[t][y * TILE_STRIDE];
+            for (int x = 0; x < CELL; x++) {
+                uint8_t idx = pal_index(tile_px((TileId)t, x, y));
+                row[x >> 1] = (x & 1) ? (uint8_t)((row[x >> 1] & 0xF0) | idx) : (uint8_t)(idx << 4);
+            }
+        }
+    }
+}
+
+void draw_tile(uint16_t gx, uint16_t gy, TileId t) {
+    blit_packed(gx * CELL, gy * CELL, CELL, CELL, atlas[t], TILE_STRIDE);
+}
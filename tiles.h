@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// CELL x CELL 타일 아틀라스 (CELL은 시작할 때 정해짐 - config.h grid_setup) - 프레임버퍼와 같은 4비트 인덱스로 미리 패킹해 둠
+// 칸 하나 그리기 = 줄마다 memcpy 한 번, 전송은 render_present가 바뀐 영역을 창 하나로 묶어서 함
+
+typedef enum {
+    TILE_EMPTY, // 빈 칸 (검은색)
+    TILE_BODY,
+    TILE_TAIL,
+    TILE_FOOD,
+    TILE_HUD, // 점수 바 칸
+    TILE_HEAD_UP, // 머리는 진행 방향마다 따로 - Dir 순서와 같음
+    TILE_HEAD_DOWN,
+    TILE_HEAD_LEFT,
+    TILE_HEAD_RIGHT,
+    TILE_BODY2, // 대전 모드 두 번째 뱀 (빨간색) - 순서는 위와 같음
+    TILE_TAIL2,
+    TILE_HUD2,  // 두 번째 뱀 점수 칸
+    TILE_HEAD2_UP,
+    TILE_HEAD2_DOWN,
+    TILE_HEAD2_LEFT,
+    TILE_HEAD2_RIGHT,
+    TILE_COUNT
+} TileId;
+
+void tiles_init(void); // 아틀라스 만들기 - pal_init(render_init) 다음에 호출
+void draw_tile(uint16_t gx, uint16_t gy, TileId t); // 격자 좌표에 타일 그리기
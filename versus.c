@@ -0,0 +1,272 @@
+#include "versus.h"
+
+#include <string.h>
+
+#include "tiles.h"
+
+static inline int eq(Point a, Point b) { return a.x == b.x && a.y == b.y; }
+static inline int cell_of(Point p) { return p.y * GRID_W + p.x; }
+static inline size_t occ_bytes(void) { return (size_t)GRID_H * OCC_WORDS * sizeof(uint64_t); }
+
+static uint32_t cell_hash(int c) { // 칸 번호 섞기 - 합으로 더해도 칸이 바뀌면 거의 항상 달라지게
+    uint32_t x = (uint32_t)c * 0x9E3779B1u;
+    return x ^ (x >> 15);
+}
+
+static void touch(VsState* v, Point p) { v->touch[v->touch_n++ % VS_TOUCH_RING] = (uint16_t)cell_of(p); }
+
+static void touch_all(VsState* v) { // 틱 하나로 타일이 바뀔 수 있는 칸 - 양쪽 머리/목/꼬리와 음식 (전후로 부르면 빠짐없음)
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        const VsSnake* s = &v->s[p];
+        touch(v, vs_snake_at(s, 0));
+        touch(v, vs_snake_at(s, 1));
+        touch(v, vs_snake_at(s, s->len - 1));
+    }
+    for (int i = 0; i < FOOD_COUNT; i++) {
+        if (v->foods[i].x != FOOD_NONE.x) touch(v, v->foods[i]);
+    }
+}
+
+static void save(VsUndo* u, void* at, int size) { // 배열 한 칸을 쓰기 전에 이전 값 기록 (u가 NULL이면 안 함)
+    if (!u) return;
+    VsWrite* w = &u->w[u->n++];
+    w->at = at;
+    w->size = size;
+    w->old = 0;
+    memcpy(&w->old, at, (size_t)size);
+}
+
+static void save_occ(VsUndo* u, uint64_t* occ, Point p) { save(u, &occ[p.y * OCC_WORDS + (p.x >> 6)], 8); }
+
+static void free_remove(VsState* v, int c, VsUndo* u) { // free_set_remove가 쓰는 세 칸을 기록하고 제거
+    FreeSet* f = &v->free;
+    if (u && f->pos[c] >= 0) {
+        save(u, &f->cells[f->pos[c]], 2);
+        save(u, &f->pos[f->cells[f->n - 1]], 2);
+        save(u, &f->pos[c], 2);
+    }
+    free_set_remove(f, c);
+}
+
+static void free_add(VsState* v, int c, VsUndo* u) {
+    FreeSet* f = &v->free;
+    if (u && f->pos[c] < 0) {
+        save(u, &f->pos[c], 2);
+        save(u, &f->cells[f->n], 2);
+    }
+    free_set_add(f, c);
+}
+
+static void push_head(VsState* v, int p, Point q, VsUndo* u) {
+    VsSnake* s = &v->s[p];
+    s->head = (s->head + SNAKE_CAP - 1) % SNAKE_CAP;
+    save(u, &s->body[s->head], sizeof(Point));
+    s->body[s->head] = q;
+    s->len++;
+    s->cell_sum += cell_hash(cell_of(q));
+    save_occ(u, v->occ, q);
+    occ_set(v->occ, q);
+    if (p == 1) {
+        save_occ(u, v->occ1, q);
+        occ_set(v->occ1, q);
+    }
+    free_remove(v, cell_of(q), u);
+}
+
+static void pop_tail(VsState* v, int p, VsUndo* u) {
+    VsSnake* s = &v->s[p];
+    Point t = vs_snake_at(s, s->len - 1);
+    s->len--;
+    s->cell_sum -= cell_hash(cell_of(t));
+    save_occ(u, v->occ, t);
+    occ_clr(v->occ, t);
+    if (p == 1) {
+        save_occ(u, v->occ1, t);
+        occ_clr(v->occ1, t);
+    }
+    free_add(v, cell_of(t), u);
+}
+
+static void spawn_food(VsState* v, int idx, VsUndo* u) { // sim.c와 같음 - 빈 칸이 없으면 슬롯을 비워 둠
+    if (v->free.n == 0) {
+        v->foods[idx] = FOOD_NONE;
+        return;
+    }
+    int c = v->free.cells[rng_below(&v->rng, (uint32_t)v->free.n)];
+    free_remove(v, c, u);
+    v->foods[idx] = (Point){ (uint16_t)(c % GRID_W), (uint16_t)(c / GRID_W) };
+}
+
+static void place(VsState* v, int p, uint16_t y, int x_tail, int step, Dir d) { // 길이 3 뱀을 꼬리부터
+    for (int i = 0; i < 3; i++) push_head(v, p, (Point){ (uint16_t)(x_tail + i * step), y }, NULL);
+    v->s[p].dir = d;
+}
+
+size_t vs_state_bytes(void) {
+    return VS_PLAYERS * arena_round(SNAKE_CAP * sizeof(Point)) + 2 * arena_round(occ_bytes()) + free_set_bytes() +
+           arena_round(VS_TOUCH_RING * sizeof(uint16_t));
+}
+
+int vs_alloc(VsState* v, Arena* a) {
+    memset(v, 0, sizeof(*v));
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        v->s[p].body = arena_alloc(a, SNAKE_CAP * sizeof(Point));
+        if (!v->s[p].body) return 0;
+    }
+    v->occ = arena_alloc(a, occ_bytes());
+    v->occ1 = arena_alloc(a, occ_bytes());
+    v->touch = arena_alloc(a, VS_TOUCH_RING * sizeof(uint16_t));
+    return v->occ && v->occ1 && v->touch && free_set_alloc(&v->free, a);
+}
+
+void vs_init(VsState* v, uint64_t seed) { // 배열은 vs_alloc에서 받은 것을 지우고 다시 씀
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        v->s[p].head = v->s[p].len = v->s[p].score = 0;
+        v->s[p].cell_sum = 0;
+        v->s[p].dir = DIR_RIGHT;
+    }
+    memset(v->occ, 0, occ_bytes());
+    memset(v->occ1, 0, occ_bytes());
+    v->tick = 0;
+    rng_seed(&v->rng, seed);
+    free_set_reset(&v->free);
+    int rows = GRID_H - HUD_ROWS;
+    place(v, 0, (uint16_t)(HUD_ROWS + rows / 3), 2, 1, DIR_RIGHT); // 위쪽 왼편에서 오른쪽으로
+    place(v, 1, (uint16_t)(HUD_ROWS + rows * 2 / 3), GRID_W - 3, -1, DIR_LEFT); // 아래쪽 오른편에서 왼쪽으로
+    for (int i = 0; i < FOOD_COUNT; i++) spawn_food(v, i, NULL);
+    v->status = VS_RUNNING;
+    v->touch_n += VS_TOUCH_RING + 1; // 판 전체가 바뀜 - 그리는 쪽은 기록이 넘친 것으로 보고 전체를 다시 비교
+}
+
+void vs_undo(VsState* v, const VsUndo* u) {
+    touch_all(v);
+    for (int i = u->n - 1; i >= 0; i--) memcpy(u->w[i].at, &u->w[i].old, (size_t)u->w[i].size); // 쓴 순서의 반대로
+    uint32_t touch_n = v->touch_n;
+    *v = u->before;
+    v->touch_n = touch_n;
+    touch_all(v);
+}
+
+static int reverse(Dir a, Dir b) {
+    return (a == DIR_UP && b == DIR_DOWN) || (a == DIR_DOWN && b == DIR_UP) ||
+           (a == DIR_LEFT && b == DIR_RIGHT) || (a == DIR_RIGHT && b == DIR_LEFT);
+}
+
+static VsStatus outcome(int lose0, int lose1) {
+    if (lose0 && lose1) return VS_DRAW;
+    if (lose0) return VS_WIN1;
+    if (lose1) return VS_WIN0;
+    return VS_RUNNING;
+}
+
+VsStatus vs_step(VsState* v, const Dir in[VS_PLAYERS], VsUndo* u) {
+    if (u) {
+        u->before = *v;
+        u->n = 0;
+    }
+    if (v->status != VS_RUNNING) return v->status;
+    v->tick++;
+    touch_all(v); // 방향만 바뀌고 끝나는 틱(충돌)도 머리 칸이 들어감
+
+    Point nh[VS_PLAYERS];
+    int ate[VS_PLAYERS], dead[VS_PLAYERS], freed[VS_PLAYERS];
+
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        VsSnake* s = &v->s[p];
+        if (in[p] != DIR_NONE && !reverse(s->dir, in[p])) s->dir = in[p];
+        nh[p] = vs_snake_at(s, 0);
+        freed[p] = 0;
+        if (s->dir == DIR_UP) nh[p].y--; // 0에서 빼면 65535가 되어 벽 검사에 걸림
+        else if (s->dir == DIR_DOWN) nh[p].y++;
+        else if (s->dir == DIR_LEFT) nh[p].x--;
+        else nh[p].x++;
+        dead[p] = nh[p].x >= GRID_W || nh[p].y >= GRID_H || nh[p].y < HUD_ROWS;
+        ate[p] = -1;
+        for (int i = 0; i < FOOD_COUNT && !dead[p]; i++) {
+            if (eq(nh[p], v->foods[i])) ate[p] = i;
+        }
+        if (!dead[p] && ate[p] < 0) { // 안 먹으면 꼬리가 먼저 빠짐 - 남의 꼬리 자리로도 들어갈 수 있음
+            occ_clr(v->occ, vs_snake_at(s, s->len - 1)); // 잠깐 비워 두고 검사 (격자 복사 없이 O(1)) - 아래서 되돌리므로 기록 안 함
+            freed[p] = 1;
+        }
+    }
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        if (!dead[p] && occ_get(v->occ, nh[p])) dead[p] = 1; // 자기 몸이나 상대 몸
+    }
+    for (int p = 0; p < VS_PLAYERS; p++) { // 되돌림 - 실제로 빼는 건 아래 pop_tail
+        if (freed[p]) occ_set(v->occ, vs_snake_at(&v->s[p], v->s[p].len - 1));
+    }
+    if (!dead[0] && !dead[1] && eq(nh[0], nh[1])) dead[0] = dead[1] = 1; // 정면 충돌 - 같은 음식을 동시에 먹는 경우 포함
+    if (dead[0] || dead[1]) return v->status = outcome(dead[0], dead[1]); // 부딪힌 틱은 움직이지 않고 끝
+
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        if (ate[p] < 0) pop_tail(v, p, u);
+        else v->s[p].score++;
+    }
+    for (int p = 0; p < VS_PLAYERS; p++) push_head(v, p, nh[p], u);
+    for (int p = 0; p < VS_PLAYERS; p++) { // 음식은 항상 0번부터 - 양쪽 난수 순서가 같아야 함
+        if (ate[p] >= 0) spawn_food(v, ate[p], u);
+    }
+    for (int i = 0; i < FOOD_COUNT && v->free.n > 0; i++) {
+        if (v->foods[i].x == FOOD_NONE.x) spawn_food(v, i, u);
+    }
+    touch_all(v);
+    return v->status = outcome(v->s[1].score >= CLEAR_SCORE, v->s[0].score >= CLEAR_SCORE);
+}
+
+static uint32_t fnv(uint32_t h, uint32_t x) { // FNV-1a, 4바이트씩
+    for (int i = 0; i < 4; i++) {
+        h ^= (x >> (i * 8)) & 0xFF;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t vs_checksum(const VsState* v) { // 필드만 차례로 - 구조체 패딩이나 원형 버퍼 위치에 영향받지 않음. 몸통은 칸 해시 합 + 머리/꼬리
+    uint32_t h = 2166136261u;
+    h = fnv(h, v->tick);
+    h = fnv(h, (uint32_t)v->status);
+    h = fnv(h, (uint32_t)v->rng.state);
+    h = fnv(h, (uint32_t)(v->rng.state >> 32));
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        const VsSnake* s = &v->s[p];
+        h = fnv(h, (uint32_t)s->len | (uint32_t)s->dir << 16 | (uint32_t)s->score << 20);
+        h = fnv(h, s->cell_sum);
+        h = fnv(h, (uint32_t)cell_of(vs_snake_at(s, 0)));
+        h = fnv(h, (uint32_t)cell_of(vs_snake_at(s, s->len - 1)));
+    }
+    for (int i = 0; i < FOOD_COUNT; i++) h = fnv(h, (uint32_t)v->foods[i].x << 16 | v->foods[i].y);
+    return h;
+}
+
+static const uint8_t heads[VS_PLAYERS] = { TILE_HEAD_UP, TILE_HEAD2_UP }; // + Dir
+static const uint8_t bodies[VS_PLAYERS] = { TILE_BODY, TILE_BODY2 };
+static const uint8_t tails[VS_PLAYERS] = { TILE_TAIL, TILE_TAIL2 };
+
+void vs_tiles(const VsState* v, uint8_t* out) {
+    memset(out, TILE_EMPTY, GRID_H * GRID_W);
+    for (int i = 0; i < FOOD_COUNT; i++) {
+        if (v->foods[i].x != FOOD_NONE.x) out[cell_of(v->foods[i])] = TILE_FOOD;
+    }
+    for (int p = 0; p < VS_PLAYERS; p++) {
+        const VsSnake* s = &v->s[p];
+        for (int i = s->len - 1; i >= 0; i--) { // 머리를 마지막에 - 겹치면 머리가 보임
+            Point q = vs_snake_at(s, i);
+            out[cell_of(q)] = i == 0 ? (uint8_t)(heads[p] + s->dir) : i == s->len - 1 ? tails[p] : bodies[p];
+        }
+    }
+}
+
+uint8_t vs_tile_at(const VsState* v, int c) { // 두 뱀은 칸을 같이 차지하지 않음 - 점유 비트보드 둘로 주인을 찾음
+    Point q = { (uint16_t)(c % GRID_W), (uint16_t)(c / GRID_W) };
+    if (!occ_get(v->occ, q)) {
+        for (int i = 0; i < FOOD_COUNT; i++) {
+            if (eq(q, v->foods[i])) return TILE_FOOD;
+        }
+        return TILE_EMPTY;
+    }
+    int p = occ_get(v->occ1, q);
+    const VsSnake* s = &v->s[p];
+    if (eq(q, vs_snake_at(s, 0))) return (uint8_t)(heads[p] + s->dir);
+    return eq(q, vs_snake_at(s, s->len - 1)) ? tails[p] : bodies[p];
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "sim.h"
+
+// 두 마리 대전 규칙 - sim.c처럼 순수 시뮬레이션 (전역 상태도, 그리기/입출력도 없음)
+// 같은 시드와 같은 입력열이면 어느 기기에서 돌려도 같은 결과 - lockstep.c가 양쪽에서 똑같이 돌림
+// 되감기(rollback)는 틱마다 남기는 되돌리기 기록(VsUndo)으로 - 상태 전체를 복사하지 않아서 틱 하나는 격자 크기와 상관없이 O(1)
+// 격자 크기 배열은 vs_alloc이 아레나에서 받아 둔 것을 그대로 씀
+
+#define VS_PLAYERS 2
+#define VS_UNDO_MAX (20 + 3 * (FOOD_COUNT + 2)) // 한 틱의 배열 쓰기 상한: 뱀마다 꼬리 4 + 머리 6, 음식 하나에 3 (최대 FOOD_COUNT + 2번)
+#define VS_TOUCH_RING 256 // 바뀐 칸 기록 - 그리는 쪽이 이보다 많이 밀리면 전체를 다시 비교
+
+typedef enum {
+    VS_RUNNING,
+    VS_WIN0, // 0번(호스트) 승
+    VS_WIN1,
+    VS_DRAW, // 같은 틱에 둘 다 죽거나 둘 다 CLEAR_SCORE
+} VsStatus;
+
+typedef struct {
+    Point* body; // [SNAKE_CAP] 원형 버퍼 - sim.c GameState와 같은 방식
+    int head, len;
+    Dir dir;
+    int score;
+    uint32_t cell_sum; // 몸통 칸 해시의 합 - 체크섬을 몸통 길이와 상관없이 구함
+} VsSnake;
+
+typedef struct {
+    VsSnake s[VS_PLAYERS];
+    uint64_t* occ; // 두 뱀이 차지한 칸 비트보드 (sim.h occ_get)
+    uint64_t* occ1; // 그중 1번 뱀 칸 - 몸통 타일 색을 칸 하나만 보고 정함
+    Point foods[FOOD_COUNT]; // 두 뱀이 같이 먹는 음식 (빈 슬롯은 FOOD_NONE)
+    FreeSet free;
+    uint32_t tick; // 진행한 틱 수
+    VsStatus status;
+    Rng rng;
+    uint16_t* touch;   // [VS_TOUCH_RING] 타일이 바뀌었을 수 있는 칸 (touch[i % RING]) - 되감기에도 늘기만 함
+    uint32_t touch_n;  // 지금까지 기록한 수 - 규칙 상태가 아니라서 체크섬/되돌리기에서 빠짐
+} VsState;
+
+typedef struct { void* at; uint64_t old; int size; } VsWrite; // 배열 한 칸의 이전 값
+
+typedef struct { // vs_step 한 번을 되돌리는 기록
+    VsState before; // 값 필드 (배열 포인터는 같음)
+    VsWrite w[VS_UNDO_MAX];
+    int n;
+} VsUndo;
+
+size_t vs_state_bytes(void); // 지금 격자에서 VsState 하나가 아레나에서 받는 크기
+int vs_alloc(VsState* v, Arena* a); // 격자 크기 배열 받기 - VsState마다 한 번. 모자라면 0
+void vs_init(VsState* v, uint64_t seed); // 새 대전: 두 뱀을 마주 보게 배치하고 음식을 놓음
+VsStatus vs_step(VsState* v, const Dir in[VS_PLAYERS], VsUndo* u); // 한 틱 진행. in: 플레이어별 방향 입력 (DIR_NONE이면 그대로), u: 되돌리기 기록 (NULL 가능)
+void vs_undo(VsState* v, const VsUndo* u); // 마지막 vs_step을 되돌림 - 여러 틱이면 최근 것부터 차례로
+uint32_t vs_checksum(const VsState* v); // 상태 요약값 - 양쪽이 같은 틱에서 비교해 어긋남(desync) 확인. O(1)
+void vs_tiles(const VsState* v, uint8_t* out); // 칸마다 그릴 타일 (TileId, out[y * GRID_W + x]) - HUD 줄은 TILE_EMPTY. O(격자)
+uint8_t vs_tile_at(const VsState* v, int c); // 칸 하나의 타일 (vs_tiles와 같은 값) - touch에 나온 칸만 다시 그릴 때
+
+static inline Point vs_snake_at(const VsSnake* s, int i) { // i=0 머리
+    return s->body[(s->head + i) % SNAKE_CAP];
+}
@@ -0,0 +1,103 @@
+#include "wake.h"
+
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "hal.h"
+#include "input.h"
+#include "metrics.h"
+#include "render.h"
+
+enum { WAKE_INPUT, WAKE_TIMER, WAKE_TIMEOUT, WAKE_REASONS }; // epoll 데이터 / 통계 칸
+
+static int ep = -1;
+static int timer_fd = -1;
+static int in_fd = -1;
+static uint64_t t_open_us = 0;
+static uint64_t woke[WAKE_REASONS]; // 이유별 깬 횟수 (한 번에 둘 다면 둘 다 셈)
+static uint64_t spurious = 0; // 준비됐다고 깼는데 읽을 게 없던 횟수 (타이머를 다시 맞춘 직후 등)
+
+int wake_open(void) {
+    struct epoll_event ev = { .events = EPOLLIN };
+    t_open_us = hal_now_us();
+    if (!hal_realtime()) return 1; // 가상 시계는 fd 없이 진행
+    in_fd = input_fd();
+    ep = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (ep < 0 || timer_fd < 0) goto fail;
+    ev.data.u32 = WAKE_TIMER;
+    if (epoll_ctl(ep, EPOLL_CTL_ADD, timer_fd, &ev) < 0) goto fail;
+    ev.data.u32 = WAKE_INPUT;
+    if (in_fd >= 0 && epoll_ctl(ep, EPOLL_CTL_ADD, in_fd, &ev) < 0) goto fail;
+    return 1;
+fail:
+    perror("wake: epoll");
+    wake_close();
+    return 0;
+}
+
+void wake_close(void) {
+    if (timer_fd >= 0) close(timer_fd);
+    if (ep >= 0) close(ep);
+    ep = timer_fd = -1;
+}
+
+static int cap_ms(int timed) { // 입력/틱 말고도 깨어나야 하는 간격 (-1이면 없음)
+    int ms = timed || render_mirror_open() ? IDLE_MS : -1;
+#ifdef METRICS
+    if (ms < 0 || ms > METRICS_PERIOD_MS) ms = METRICS_PERIOD_MS; // 파일에 한 줄씩 쓰는 간격은 지킴
+#endif
+    return ms;
+}
+
+static void arm(uint64_t t_us) { // 0이면 끔
+    struct itimerspec its = { { 0, 0 }, { (time_t)(t_us / 1000000u), (long)(t_us % 1000000u) * 1000L } };
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void wait_fds(int ms) {
+    struct epoll_event evs[2];
+    int n = epoll_wait(ep, evs, 2, ms);
+    if (n == 0) woke[WAKE_TIMEOUT]++;
+    for (int i = 0; i < n; i++) {
+        uint64_t v;
+        woke[evs[i].data.u32]++;
+        if (evs[i].data.u32 == WAKE_INPUT) { // 이벤트 자체는 input_poll로 꺼냄
+            if (eventfd_read(in_fd, &v) != 0) spurious++;
+        } else if (read(timer_fd, &v, sizeof(v)) != (ssize_t)sizeof(v)) { // 만료 횟수 8바이트 - EAGAIN이면 이미 다시 맞춤
+            spurious++;
+        }
+    }
+}
+
+void wake_tick(uint64_t t_us) {
+    if (ep < 0) {
+        uint64_t limit = hal_now_us() + (uint64_t)INPUT_POLL_MS * 1000u;
+        hal_sleep_until_us(t_us < limit ? t_us : limit);
+        return;
+    }
+    arm(t_us ? t_us : 1); // 이미 지났으면 바로 깸
+    wait_fds(cap_ms(0));
+}
+
+void wake_idle(int timed) {
+    if (ep < 0) {
+        hal_delay_ms(IDLE_MS);
+        return;
+    }
+    arm(0);
+    wait_fds(cap_ms(timed));
+}
+
+void wake_report(void) {
+    if (!hal_realtime()) return;
+    uint64_t sum = woke[WAKE_INPUT] + woke[WAKE_TIMER] + woke[WAKE_TIMEOUT];
+    double s = (double)(hal_now_us() - t_open_us) / 1e6;
+    printf("wake: %llu wakeups (input %llu, tick %llu, timeout %llu, spurious %llu), %.1f/s\n", (unsigned long long)sum,
+           (unsigned long long)woke[WAKE_INPUT], (unsigned long long)woke[WAKE_TIMER],
+           (unsigned long long)woke[WAKE_TIMEOUT], (unsigned long long)spurious, s > 0 ? (double)sum / s : 0.0);
+}
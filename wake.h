@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// 게임 루프 대기 - 할 일이 생길 때까지 잠 (메뉴/일시정지/게임 오버 화면에서 CPU를 거의 안 씀)
+// 실제 시계(hal_realtime)에서는 epoll 하나에 다음 fd를 모아 기다림
+//  - 입력 eventfd (input_fd): 샘플러가 눌림/뗌 이벤트를 큐에 넣으면 깸
+//  - timerfd: 플레이 중 다음 틱 마감 (CLOCK_MONOTONIC 절대 시각 - hal_now_us와 같은 시계)
+// SDL2에는 기다릴 수 있는 이벤트 fd가 없어서 미러 창이 열려 있으면 IDLE_MS마다 깨어 창 이벤트를 확인함
+// 가상 시계(호스트 백엔드)에서는 epoll 없이 예전처럼 가상 시간을 INPUT_POLL_MS/IDLE_MS씩 진행
+
+int wake_open(void);  // input_start 다음에 부름. 실패하면 0 (그러면 wake_*가 예전처럼 주기적으로 깸)
+void wake_close(void);
+void wake_tick(uint64_t t_us); // 틱 마감 t_us(hal_now_us 기준)까지 또는 입력이 올 때까지 잠
+void wake_idle(int timed);     // 입력이 올 때까지 잠. timed면 IDLE_MS 뒤에는 깸 (자동 조종이 메뉴에서 버튼을 눌러야 함)
+void wake_report(void);        // 깬 횟수/이유 출력
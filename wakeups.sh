@@ -0,0 +1,72 @@
+#!/bin/sh
+# 대기 중 깨어나는 횟수 측정 - spidev 백엔드를 spidev_shim.c(가짜 spidev/gpiochip, LD_PRELOAD)로 보드 없이 돌리고
+# /proc에서 모든 스레드의 문맥 전환 수(voluntary + nonvoluntary)와 CPU 시간(utime + stime)을 재서 초당 값으로 출력
+#  idle menu      : 메뉴 화면에서 입력 없이 대기 (깰 일이 없어야 함)
+#  idle, no edge  : 가짜 gpiochip이 엣지 요청을 거절(SPISHIM_NOEDGE) - 엣지 fd 없이 샘플러가 주기적으로 읽는 대체 경로
+#  autopilot play : 자동 조종으로 계속 플레이 - 틱(TICK_MS)과 전송 스레드만큼은 깨는 게 정상
+# ./wakeups.sh [비교할 리비전] [초]   # 리비전을 주면 git archive로 그 트리도 같은 방법으로 빌드해서 먼저 출력 (기본 10초)
+# bcm2835 백엔드는 /dev/mem이 필요해서 가짜 장치로 못 돌림 - 라즈베리파이에서 root이고 libbcm2835가 있으면
+# 지금 트리의 bcm2835 빌드를 실제 핀(/dev/gpiochip0 엣지)으로 따로 잼 (엣지 없는 경우는 가짜 칩이 있어야 해서 뺌)
+
+cd "$(dirname "$0")" || exit 1
+REV=$1
+SECS=${2:-10}
+T=$(mktemp -d) || exit 1
+trap 'rm -rf "$T"' EXIT
+
+gcc -O2 -shared -fPIC -o "$T/shim.so" spidev_shim.c -ldl || exit 1
+PRELOAD=$T/shim.so
+
+build() { # $1 소스 디렉터리, $2 실행 파일, $3 백엔드 (기본 hal_spidev.c) - 게임 소스 전부 + 백엔드 (별도 프로그램은 뺌)
+    srcs=$(cd "$1" && ls *.c | grep -v -e '^hal_' -e '^batch\.c$' -e '^capdec\.c$' -e '_check\.c$' -e '^spidev_shim\.c$')
+    (cd "$1" && gcc -O2 -DNO_SDL -o "$2" $srcs ${3:-hal_spidev.c} -pthread -lm $4)
+}
+
+switches() { # $1 pid - 스레드마다의 문맥 전환 합
+    cat /proc/$1/task/*/status 2>/dev/null | awk '/voluntary_ctxt_switches/ { s += $2 } END { print s + 0 }'
+}
+
+cpu_ticks() { # $1 pid - utime + stime (clock tick)
+    awk '{ print $14 + $15 }' /proc/$1/stat
+}
+
+measure() { # $1 이름, $2 실행 파일, 나머지: 환경 변수 (PRELOAD를 unset하면 가짜 장치 없이 실제 장치로)
+    name=$1 bin=$2
+    shift 2
+    env "$@" ${PRELOAD+LD_PRELOAD="$PRELOAD"} "$bin" > /dev/null 2>&1 &
+    pid=$!
+    sleep 1 # 시작(패널 초기화, 메뉴 그리기)은 빼고 잼
+    s0=$(switches $pid) c0=$(cpu_ticks $pid)
+    sleep "$SECS"
+    s1=$(switches $pid) c1=$(cpu_ticks $pid)
+    kill $pid
+    wait $pid 2> /dev/null
+    hz=$(getconf CLK_TCK)
+    printf "  %-16s %7d wakeups/s  %5d ms cpu in %ss\n" "$name" $(((s1 - s0) / SECS)) $(((c1 - c0) * 1000 / hz)) "$SECS"
+}
+
+run_all() { # $1 제목, $2 실행 파일
+    echo "$1"
+    measure "idle menu" "$2"
+    measure "idle, no edge" "$2" SPISHIM_NOEDGE=1
+    measure "autopilot play" "$2" SNAKE_AUTOPILOT=0 SNAKE_SEED=1
+}
+
+if [ -n "$REV" ]; then
+    mkdir "$T/base"
+    git archive "$REV" | tar -x -C "$T/base" || exit 1
+    build "$T/base" "$T/snake_base" || exit 1
+    run_all "$REV ($(git log -1 --format=%h "$REV"))" "$T/snake_base"
+fi
+build . "$T/snake_now" || exit 1
+run_all "working tree" "$T/snake_now"
+
+if [ "$(id -u)" = 0 ] && [ -e /dev/gpiomem ] && echo '#include <bcm2835.h>' | gcc -E - > /dev/null 2>&1; then
+    build . "$T/snake_bcm" hal_bcm2835.c -lbcm2835 || exit 1
+    unset PRELOAD
+    echo "working tree, bcm2835 backend (real pins)"
+    measure "idle menu" "$T/snake_bcm"
+    measure "autopilot play" "$T/snake_bcm" SNAKE_AUTOPILOT=0 SNAKE_SEED=1
+else
+    echo "bcm2835 backend: skipped (needs root and libbcm2835 on the Pi)"
+fi